@@ -0,0 +1,79 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/buffer_view.h"
+#include "ha/dsp_tool_box/core/types.h"
+
+namespace ha::dtb::core {
+
+/**
+ * @brief Describes the samples of a rendered block. Producers always write
+ * the buffer, the state only lets consumers skip reading it.
+ */
+struct BlockState final
+{
+    enum class Kind : mut_u8
+    {
+        //! Samples change within the block
+        Dynamic = 0,
+        //! All samples equal value
+        Constant,
+        //! All samples are 0
+        Silent
+    };
+
+    Kind kind      = Kind::Dynamic;
+    mut_real value = real(0.);
+};
+
+struct BlockStateImpl final
+{
+    static BlockState dynamic();
+
+    /**
+     * @brief Constant block of value, Silent if value is 0
+     */
+    static BlockState constant(real value);
+
+    static BlockState silent();
+
+    /**
+     * @brief True for Constant and Silent blocks
+     */
+    static bool is_constant(BlockState const& state);
+
+    static bool is_silent(BlockState const& state);
+
+    /**
+     * @brief Scans the samples of a block of unknown state
+     */
+    static BlockState detect(ConstChannelView const& in);
+
+    /**
+     * @brief VCA, out = in * gain. Skips reading constant inputs and
+     * multiplying silent ones. out may view the same samples as in or gain.
+     *
+     * @return Returns the state of out
+     */
+    static BlockState multiply(ConstChannelView const& in,
+                               BlockState const& in_state,
+                               ConstChannelView const& gain,
+                               BlockState const& gain_state,
+                               MutChannelView const& out);
+
+    /**
+     * @brief Modulation summing, sum += depth * mod. Skips silent
+     * modulators and adds constant ones as a scalar.
+     *
+     * @param sum_state State of sum, updated
+     */
+    static void accumulate(MutChannelView const& sum,
+                           BlockState& sum_state,
+                           ConstChannelView const& mod,
+                           BlockState const& mod_state,
+                           real depth);
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::core
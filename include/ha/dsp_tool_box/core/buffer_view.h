@@ -0,0 +1,266 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/types.h"
+#include <cassert>
+#include <cstdint>
+
+namespace ha::dtb::core {
+
+/**
+ * @brief Non-owning view of one channel. Samples are stride elements apart,
+ * e.g. 1 for planar and the number of channels for interleaved buffers.
+ */
+template <typename T>
+struct ChannelView final
+{
+    T* data             = nullptr;
+    mut_i32 num_samples = 0;
+    mut_i32 stride      = 1;
+    //! Alignment of data in bytes, a power of two
+    mut_u32 alignment = alignof(T);
+};
+
+using ConstChannelView = ChannelView<real>;
+using MutChannelView   = ChannelView<mut_real>;
+
+/**
+ * @brief Non-owning view of a block of many channels. Holds either one
+ * pointer per channel (planar host buffers) or one base pointer with channel
+ * and sample strides (interleaved or channel after channel).
+ */
+template <typename T>
+struct BlockView final
+{
+    T* const* channels     = nullptr;
+    T* data                = nullptr;
+    mut_i32 num_channels   = 0;
+    mut_i32 num_samples    = 0;
+    mut_i32 offset         = 0;
+    mut_i32 channel_stride = 0;
+    mut_i32 sample_stride  = 1;
+    //! Alignment of the first sample of every channel in bytes
+    mut_u32 alignment = alignof(T);
+};
+
+using ConstBlockView = BlockView<real>;
+using MutBlockView   = BlockView<mut_real>;
+
+struct BufferViewImpl final
+{
+    //! Alignment reported at most, enough for AVX-512
+    static constexpr u32 MAX_ALIGNMENT = 64;
+
+    /**
+     * @brief Largest power of two (up to MAX_ALIGNMENT) dividing the address
+     */
+    static u32 alignment_of(void const* ptr)
+    {
+        auto const address = reinterpret_cast<std::uintptr_t>(ptr);
+        auto const lowest  = address & (~address + 1);
+        return lowest == 0 || lowest > MAX_ALIGNMENT
+                   ? MAX_ALIGNMENT
+                   : static_cast<mut_u32>(lowest);
+    }
+
+    /**
+     * @brief View of num_samples samples, stride elements apart
+     */
+    template <typename T>
+    static ChannelView<T> channel(T* data, i32 num_samples, i32 stride = 1)
+    {
+        return {data, num_samples, stride, alignment_of(data)};
+    }
+
+    /**
+     * @brief View of planar host buffers, one pointer per channel
+     */
+    template <typename T>
+    static BlockView<T>
+    planar(T* const* channels, i32 num_channels, i32 num_samples)
+    {
+        BlockView<T> view;
+        view.channels     = channels;
+        view.num_channels = num_channels;
+        view.num_samples  = num_samples;
+        view.alignment    = MAX_ALIGNMENT;
+        for (mut_i32 i = 0; i < num_channels; ++i)
+        {
+            u32 const alignment = alignment_of(channels[i]);
+            if (alignment < view.alignment)
+                view.alignment = alignment;
+        }
+        return view;
+    }
+
+    /**
+     * @brief View of one buffer holding num_channels channels one after the
+     * other
+     */
+    template <typename T>
+    static BlockView<T> contiguous(T* data, i32 num_channels, i32 num_samples)
+    {
+        u32 const first  = alignment_of(data);
+        u32 const second = alignment_of(data + num_samples);
+
+        BlockView<T> view;
+        view.data           = data;
+        view.num_channels   = num_channels;
+        view.num_samples    = num_samples;
+        view.channel_stride = num_samples;
+        view.alignment      = first < second ? first : second;
+        return view;
+    }
+
+    /**
+     * @brief View of one buffer holding frames of num_channels samples
+     */
+    template <typename T>
+    static BlockView<T>
+    interleaved(T* data, i32 num_channels, i32 num_samples)
+    {
+        BlockView<T> view;
+        view.data           = data;
+        view.num_channels   = num_channels;
+        view.num_samples    = num_samples;
+        view.channel_stride = 1;
+        view.sample_stride  = num_channels;
+        view.alignment      = num_channels == 1
+                                  ? alignment_of(data)
+                                  : static_cast<mut_u32>(alignof(T));
+        return view;
+    }
+
+    /**
+     * @brief View of one channel of a block
+     */
+    template <typename T>
+    static ChannelView<T> channel(BlockView<T> const& block, i32 index)
+    {
+        assert(index >= 0 && index < block.num_channels);
+        if (block.channels)
+            return channel(block.channels[index] + block.offset,
+                           block.num_samples);
+
+        T* const first = block.data + index * block.channel_stride +
+                         block.offset * block.sample_stride;
+        return channel(first, block.num_samples, block.sample_stride);
+    }
+
+    /**
+     * @brief View of num_samples samples starting at offset
+     */
+    template <typename T>
+    static ChannelView<T>
+    sub_range(ChannelView<T> const& view, i32 offset, i32 num_samples)
+    {
+        assert(offset >= 0 && offset + num_samples <= view.num_samples);
+        return channel(view.data + offset * view.stride, num_samples,
+                       view.stride);
+    }
+
+    /**
+     * @brief View of num_samples samples of all channels starting at offset
+     */
+    template <typename T>
+    static BlockView<T>
+    sub_range(BlockView<T> const& view, i32 offset, i32 num_samples)
+    {
+        assert(offset >= 0 && offset + num_samples <= view.num_samples);
+        BlockView<T> sub = view;
+        sub.offset += offset;
+        sub.num_samples = num_samples;
+        if (view.channels)
+        {
+            sub.alignment = MAX_ALIGNMENT;
+            for (mut_i32 i = 0; i < view.num_channels; ++i)
+            {
+                u32 const alignment =
+                    alignment_of(view.channels[i] + sub.offset);
+                if (alignment < sub.alignment)
+                    sub.alignment = alignment;
+            }
+        }
+        else if (view.sample_stride == 1)
+        {
+            u32 const alignment = alignment_of(view.data + sub.offset);
+            if (alignment < sub.alignment)
+                sub.alignment = alignment;
+        }
+        return sub;
+    }
+
+    /**
+     * @brief Read only view of a writable view
+     */
+    static ConstChannelView as_const(MutChannelView const& view)
+    {
+        return {view.data, view.num_samples, view.stride, view.alignment};
+    }
+
+    static ConstBlockView as_const(MutBlockView const& view)
+    {
+        ConstBlockView result;
+        result.channels       = view.channels;
+        result.data           = view.data;
+        result.num_channels   = view.num_channels;
+        result.num_samples    = view.num_samples;
+        result.offset         = view.offset;
+        result.channel_stride = view.channel_stride;
+        result.sample_stride  = view.sample_stride;
+        result.alignment      = view.alignment;
+        return result;
+    }
+
+    /**
+     * @brief True if the samples are adjacent and data is aligned to bytes
+     */
+    template <typename T>
+    static bool is_aligned(ChannelView<T> const& view, u32 bytes)
+    {
+        return view.stride == 1 && view.alignment >= bytes;
+    }
+
+    /**
+     * @brief True if the block is a single buffer of frames holding one sample
+     * per channel, e.g. the layout of OnePoleBankImpl::process
+     */
+    template <typename T>
+    static bool is_interleaved(BlockView<T> const& view)
+    {
+        return view.channels == nullptr && view.channel_stride == 1 &&
+               view.sample_stride == view.num_channels;
+    }
+
+    /**
+     * @brief Pointer to the first sample of the view of is_interleaved
+     */
+    template <typename T>
+    static T* frames(BlockView<T> const& view)
+    {
+        assert(is_interleaved(view));
+        return view.data + view.offset * view.sample_stride;
+    }
+
+    /**
+     * @brief Sets all samples of a channel to value
+     */
+    static void fill(MutChannelView const& view, real value)
+    {
+        for (mut_i32 i = 0; i < view.num_samples; ++i)
+            view.data[i * view.stride] = value;
+    }
+
+    /**
+     * @brief Sample at index of a channel
+     */
+    template <typename T>
+    static T& at(ChannelView<T> const& view, i32 index)
+    {
+        return view.data[index * view.stride];
+    }
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::core
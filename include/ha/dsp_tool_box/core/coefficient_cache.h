@@ -0,0 +1,192 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ha::dtb::core {
+
+/**
+ * @brief Interns immutable coefficient records. Instances asking for the same
+ * key share one cache line aligned record instead of storing a copy each.
+ *
+ * Records stay alive as long as the cache holds them, even if no instance
+ * refers to them anymore. Call collect from a non-realtime thread to release
+ * records nobody holds. A CoefficientSlot holds a replaced record until the
+ * realtime thread has acknowledged a later block, so collect never frees a
+ * record the realtime thread may still read. None of the methods are
+ * realtime safe.
+ *
+ * @tparam Key Ordered key, e.g. std::array of the parameters
+ * @tparam Record Immutable coefficient record
+ */
+template <typename Key, typename Record>
+class CoefficientCache final
+{
+public:
+    //-------------------------------------------------------------------------
+    using RecordPtr = std::shared_ptr<Record const>;
+
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * @brief Returns the record of key. Creates it with make(key) if it does
+     * not exist yet.
+     */
+    template <typename Factory>
+    RecordPtr intern(Key const& key, Factory&& make)
+    {
+        std::lock_guard<std::mutex> const lock(mutex);
+        auto iter = records.find(key);
+        if (iter != records.end())
+            return iter->second;
+
+        auto holder = std::make_shared<AlignedRecord>(AlignedRecord{make(key)});
+        RecordPtr record(holder, &holder->value);
+        records.emplace(key, record);
+        return record;
+    }
+
+    /**
+     * @brief Releases all records no instance refers to anymore
+     *
+     * @return Returns the number of released records
+     */
+    std::size_t collect()
+    {
+        std::lock_guard<std::mutex> const lock(mutex);
+        std::size_t num_released = 0;
+        for (auto iter = records.begin(); iter != records.end();)
+        {
+            if (iter->second.use_count() == 1)
+            {
+                iter = records.erase(iter);
+                num_released++;
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+
+        return num_released;
+    }
+
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> const lock(mutex);
+        return records.size();
+    }
+
+    //-------------------------------------------------------------------------
+private:
+    struct alignas(CACHE_LINE_SIZE) AlignedRecord
+    {
+        Record value;
+    };
+
+    mutable std::mutex mutex;
+    std::map<Key, RecordPtr> records;
+};
+
+/**
+ * @brief Publishes an interned record to the realtime thread. Swapping the
+ * record is a single atomic pointer store. The realtime thread reads the
+ * current record with load, e.g. once per block.
+ *
+ * Every store starts a new epoch. A replaced record is retired with the
+ * epoch of its replacement and released once the realtime thread has called
+ * acknowledge in that epoch or a later one.
+ */
+template <typename Record>
+class CoefficientSlot final
+{
+public:
+    //-------------------------------------------------------------------------
+    using RecordPtr = std::shared_ptr<Record const>;
+
+    CoefficientSlot() = default;
+    explicit CoefficientSlot(RecordPtr record) { store(std::move(record)); }
+
+    CoefficientSlot(CoefficientSlot const&) = delete;
+    CoefficientSlot& operator=(CoefficientSlot const&) = delete;
+
+    /**
+     * @brief Current record. Realtime safe. The record stays valid until
+     * the next call to acknowledge.
+     */
+    Record const* load() const
+    {
+        return current.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Tells the slot that no record loaded before is read anymore.
+     * Call from the realtime thread once per block, before load. Realtime
+     * safe.
+     */
+    void acknowledge()
+    {
+        acknowledged.store(published.load(std::memory_order_acquire),
+                           std::memory_order_release);
+    }
+
+    /**
+     * @brief Swaps the record. Call from the non-realtime thread only. The
+     * previous record is retired until the realtime thread acknowledges the
+     * swap, \sa reclaim
+     */
+    void store(RecordPtr record)
+    {
+        std::uint64_t const epoch =
+            published.load(std::memory_order_relaxed) + 1;
+        if (owner)
+            retired.emplace_back(epoch, std::move(owner));
+
+        owner = std::move(record);
+        current.store(owner.get(), std::memory_order_release);
+        published.store(epoch, std::memory_order_release);
+        reclaim();
+    }
+
+    /**
+     * @brief Releases retired records the realtime thread has acknowledged.
+     * Call from the non-realtime thread only, e.g. before
+     * CoefficientCache::collect.
+     *
+     * @return Returns the number of records still retired
+     */
+    std::size_t reclaim()
+    {
+        std::uint64_t const epoch =
+            acknowledged.load(std::memory_order_acquire);
+        auto const is_acknowledged = [epoch](Retired const& entry) {
+            return entry.first <= epoch;
+        };
+        retired.erase(
+            std::remove_if(retired.begin(), retired.end(), is_acknowledged),
+            retired.end());
+        return retired.size();
+    }
+
+    //-------------------------------------------------------------------------
+private:
+    using Retired = std::pair<std::uint64_t, RecordPtr>;
+
+    std::atomic<Record const*> current{nullptr};
+    std::atomic<std::uint64_t> published{0};
+    std::atomic<std::uint64_t> acknowledged{0};
+    RecordPtr owner;
+    std::vector<Retired> retired;
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::core
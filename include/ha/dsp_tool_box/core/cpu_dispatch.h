@@ -0,0 +1,134 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/types.h"
+
+namespace ha::dtb::core {
+
+/**
+ * @brief Instruction sets the block kernels are built for
+ */
+enum class Isa
+{
+    Scalar = 0,
+    SSE2,
+    AVX2,
+    AVX512,
+    NEON,
+    Count
+};
+
+/**
+ * @brief Block kernels of one instruction set. All kernels operate on
+ * num elements at once and are free of loop carried dependencies.
+ */
+struct BlockKernels final
+{
+    /**
+     * @brief One sample of num one-pole filters. Settled filters (in == z)
+     * keep their value like OnePoleImpl::process does.
+     */
+    void (*one_pole_step)(real const* a,
+                          real const* b,
+                          mut_real* z,
+                          real const* in,
+                          mut_real* out,
+                          i32 num);
+
+    /**
+     * @brief Advances num free running phases by num_samples and wraps them
+     * like PhaseImpl::advance does. Sets overflows to 1 on overflow.
+     */
+    void (*advance_phases)(mut_real* values,
+                           real const* increments,
+                           mut_u8* overflows,
+                           i32 num_samples,
+                           i32 num);
+
+    /**
+     * @brief out = easing::ease_virus_ti(in)
+     */
+    void (*ease_virus_ti)(real const* in, mut_real* out, i32 num);
+
+    /**
+     * @brief out = from + (to - from) * (eased ? ease_virus_ti(x) : x),
+     * \sa adsr_envelope::evaluate
+     */
+    void (*evaluate_segments)(real const* x,
+                              real const* from,
+                              real const* to,
+                              u8 const* eased,
+                              mut_real* out,
+                              i32 num);
+
+    /**
+     * @brief out[i] = sum of taps[k] * in[i + k] for k in [0, num_taps), in
+     * holds num + num_taps - 1 samples. Sums in the same order on all
+     * instruction sets.
+     */
+    void (*fir)(real const* in,
+                real const* taps,
+                mut_real* out,
+                i32 num_taps,
+                i32 num);
+};
+
+/**
+ * @brief Selects the block kernels at runtime. The best instruction set
+ * supported by the CPU is used unless one is forced, either by the CMake
+ * option DTB_FORCE_ISA, the environment variable HA_DTB_FORCE_ISA or force().
+ *
+ * The Scalar kernels match the scalar algorithms exactly. All other kernels
+ * use a polynomial approximation of the easing curve, its accuracy is checked
+ * by dsp-tool-box_validate.
+ */
+struct CpuDispatchImpl final
+{
+    /**
+     * @brief Checks if kernels of isa are built and supported by the CPU
+     */
+    static bool is_supported(Isa isa);
+
+    /**
+     * @brief The best instruction set supported by the CPU
+     */
+    static Isa best_supported();
+
+    /**
+     * @brief The instruction set of kernels()
+     */
+    static Isa active();
+
+    /**
+     * @brief Forces an instruction set, e.g. for testing. Not realtime safe.
+     *
+     * @return Returns false and keeps the active one if isa is not supported
+     */
+    static bool force(Isa isa);
+
+    /**
+     * @brief The kernels of the active instruction set. Realtime safe.
+     */
+    static BlockKernels const& kernels();
+
+    /**
+     * @brief The kernels of isa, which must be supported
+     */
+    static BlockKernels const& kernels(Isa isa);
+
+    /**
+     * @brief Lower case name of isa, e.g. "avx2"
+     */
+    static char const* to_string(Isa isa);
+
+    /**
+     * @brief Parses a lower case name
+     *
+     * @return Returns false if name is unknown
+     */
+    static bool from_string(char const* name, Isa& isa);
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::core
@@ -0,0 +1,163 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/spsc_ring_buffer.h"
+#include "ha/dsp_tool_box/core/types.h"
+#include <array>
+#include <cstddef>
+
+//! Set by the CMake option DTB_ENABLE_INSTRUMENTATION. When 0, all
+//! HA_DTB_PROFILE_* hooks compile to nothing.
+#ifndef HA_DTB_ENABLE_INSTRUMENTATION
+#define HA_DTB_ENABLE_INSTRUMENTATION 0
+#endif
+
+namespace ha::dtb::core {
+
+/**
+ * @brief Primitives and banks which report cycles and calls
+ */
+enum class Probe
+{
+    OnePole = 0,
+    Phase,
+    AdsrEnvelope,
+    OnePoleBank,
+    PhaseBank,
+    AdsrEnvelopeBank,
+    Mseg,
+    MsegBank,
+    AutomationLanes,
+    Oversampler,
+    Count
+};
+
+static constexpr std::size_t NUM_PROBES =
+    static_cast<std::size_t>(Probe::Count);
+static constexpr std::size_t NUM_ADSR_STAGES = 5;
+
+/**
+ * @brief Counters of one processed block
+ */
+struct BlockReport final
+{
+    mut_u64 block_index = 0;
+    std::array<mut_u64, NUM_PROBES> cycles{};
+    std::array<mut_u32, NUM_PROBES> calls{};
+    //! One-pole filters whose state did not move, counted once per filter
+    //! and call, e.g. once per bank filter and block
+    mut_u32 one_pole_settled = 0;
+    mut_u32 one_pole_active  = 0;
+    //! Envelope voices per stage, counted once per voice and read. A block
+    //! read counts its voice once, a bank read all of its voices.
+    std::array<mut_u32, NUM_ADSR_STAGES> adsr_stage_voices{};
+    mut_u32 phase_overflows = 0;
+};
+
+/**
+ * @brief Collects BlockReports of one realtime thread. The realtime thread
+ * brackets its block with begin_block/end_block, a non-realtime thread drains
+ * the reports with try_pop.
+ */
+struct Profiler final
+{
+    static constexpr std::size_t REPORT_CAPACITY = 256;
+
+    BlockReport current;
+    mut_u64 block_counter = 0;
+    std::atomic<std::uint32_t> dropped_reports{0};
+    SpscRingBuffer<BlockReport, REPORT_CAPACITY> reports;
+};
+
+struct InstrumentationImpl final
+{
+    /**
+     * @brief Resets the counters and makes the profiler the active one of the
+     * calling thread. Call from the realtime thread.
+     */
+    static void begin_block(Profiler& self);
+
+    /**
+     * @brief Publishes the counters of the current block and deactivates the
+     * profiler. Reports are dropped (and counted) when the consumer lags
+     * behind. Call from the realtime thread.
+     */
+    static void end_block(Profiler& self);
+
+    /**
+     * @brief Pops the oldest report. Call from the non-realtime thread.
+     *
+     * @return Returns false if no report is available
+     */
+    static bool try_pop(Profiler& self, BlockReport& report);
+
+    /**
+     * @brief The report of the calling thread's active profiler
+     *
+     * @return Returns nullptr outside of begin_block/end_block
+     */
+    static BlockReport* active_report();
+
+    /**
+     * @brief Reads the CPU's time stamp counter (or a steady clock in
+     * nanoseconds on platforms without one)
+     */
+    static u64 read_cycle_counter();
+};
+
+/**
+ * @brief Adds the cycles spent in its scope to the active report
+ */
+class ScopedCycleCounter final
+{
+public:
+    //-------------------------------------------------------------------------
+    explicit ScopedCycleCounter(Probe probe)
+    : index(static_cast<std::size_t>(probe))
+    , start(InstrumentationImpl::read_cycle_counter())
+    {
+    }
+
+    ~ScopedCycleCounter()
+    {
+        if (auto* report = InstrumentationImpl::active_report())
+        {
+            report->cycles[index] +=
+                InstrumentationImpl::read_cycle_counter() - start;
+            report->calls[index]++;
+        }
+    }
+
+    ScopedCycleCounter(ScopedCycleCounter const&) = delete;
+    ScopedCycleCounter& operator=(ScopedCycleCounter const&) = delete;
+
+    //-------------------------------------------------------------------------
+private:
+    std::size_t const index;
+    u64 start;
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::core
+
+#if HA_DTB_ENABLE_INSTRUMENTATION
+#define HA_DTB_PROFILE_SCOPE(probe)                                            \
+    ::ha::dtb::core::ScopedCycleCounter ha_dtb_scoped_cycle_counter(probe)
+#define HA_DTB_PROFILE_COUNT(member)                                           \
+    do                                                                         \
+    {                                                                          \
+        if (auto* r = ::ha::dtb::core::InstrumentationImpl::active_report())   \
+            r->member++;                                                       \
+    } while (false)
+#define HA_DTB_PROFILE_COUNT_AT(member, index)                                 \
+    do                                                                         \
+    {                                                                          \
+        if (auto* r = ::ha::dtb::core::InstrumentationImpl::active_report())   \
+            r->member[static_cast<std::size_t>(index)]++;                      \
+    } while (false)
+#else
+#define HA_DTB_PROFILE_SCOPE(probe) ((void)0)
+#define HA_DTB_PROFILE_COUNT(member) ((void)0)
+#define HA_DTB_PROFILE_COUNT_AT(member, index) ((void)0)
+#endif
@@ -0,0 +1,85 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace ha::dtb::core {
+
+/**
+ * @brief Lock-free single producer, single consumer ring buffer. The
+ * producer (e.g. the realtime thread) calls try_push, the consumer (e.g. a
+ * UI or logging thread) calls try_pop. Neither call blocks nor allocates.
+ *
+ * @tparam T Trivially copyable element type
+ * @tparam Capacity Number of elements, must be a power of two
+ */
+template <typename T, std::size_t Capacity>
+class SpscRingBuffer final
+{
+public:
+    static_assert((Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+    //-------------------------------------------------------------------------
+    SpscRingBuffer() = default;
+
+    /**
+     * @brief Pushes an element. Call from the producer thread only.
+     *
+     * @return Returns false if the buffer is full and the element got dropped
+     */
+    bool try_push(T const& element)
+    {
+        std::size_t const write = write_pos.load(std::memory_order_relaxed);
+        std::size_t const read  = read_pos.load(std::memory_order_acquire);
+        if (write - read >= Capacity)
+            return false;
+
+        elements[write & MASK] = element;
+        write_pos.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pops an element. Call from the consumer thread only.
+     *
+     * @return Returns false if the buffer is empty
+     */
+    bool try_pop(T& element)
+    {
+        std::size_t const read  = read_pos.load(std::memory_order_relaxed);
+        std::size_t const write = write_pos.load(std::memory_order_acquire);
+        if (read == write)
+            return false;
+
+        element = elements[read & MASK];
+        read_pos.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Number of elements currently readable. Only a snapshot when
+     * called while the other thread is active.
+     */
+    std::size_t size() const
+    {
+        return write_pos.load(std::memory_order_acquire) -
+               read_pos.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    //-------------------------------------------------------------------------
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    std::array<T, Capacity> elements{};
+    alignas(64) std::atomic<std::size_t> write_pos{0};
+    alignas(64) std::atomic<std::size_t> read_pos{0};
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::core
@@ -12,9 +12,21 @@ namespace dtb {
 using i32     = std::int32_t const;
 using mut_i32 = std::remove_const<i32>::type;
 
+using u8     = std::uint8_t const;
+using mut_u8 = std::remove_const<u8>::type;
+
+using u16     = std::uint16_t const;
+using mut_u16 = std::remove_const<u16>::type;
+
+using u32     = std::uint32_t const;
+using mut_u32 = std::remove_const<u32>::type;
+
+using u64     = std::uint64_t const;
+using mut_u64 = std::remove_const<u64>::type;
+
 using real     = float const;
 using mut_real = std::remove_const<real>::type;
 
 //-----------------------------------------------------------------------------
 } // namespace dtb
-} // namespace ha
\ No newline at end of file
+} // namespace ha
@@ -2,8 +2,12 @@
 
 #pragma once
 
+#include "ha/dsp_tool_box/core/block_state.h"
+#include "ha/dsp_tool_box/core/buffer_view.h"
 #include "ha/dsp_tool_box/core/types.h"
+#include <cstddef>
 #include <math.h>
+#include <memory>
 
 namespace ha::dtb::filtering {
 
@@ -18,13 +22,70 @@ struct OnePole final
     mut_real z = 0;
 };
 
+/**
+ * @brief Immutable coefficients shared by many one-pole filters with the same
+ * settings. The per filter state shrinks to z. \sa OnePoleImpl::intern
+ */
+struct OnePoleCoefficients final
+{
+    mut_real a = 0;
+    mut_real b = 0;
+};
+
 struct OnePoleImpl final
 {
     static OnePole create(real a = 0.9);
     static void update_pole(OnePole& self, real a);
     static real process(OnePole& self, real in);
+
+    /**
+     * @brief Processes a block. in and out may view the same samples.
+     *
+     * @return Returns Constant if the filter stayed settled
+     */
+    static core::BlockState process(OnePole& self,
+                                    core::ConstChannelView const& in,
+                                    core::MutChannelView const& out);
+
+    /**
+     * @brief Processes a block. A constant input is not read and a settled
+     * filter with constant input only fills out.
+     */
+    static core::BlockState process(OnePole& self,
+                                    core::ConstChannelView const& in,
+                                    core::BlockState const& in_state,
+                                    core::MutChannelView const& out);
+
+    /**
+     * @brief Processes a block in place
+     */
+    static core::BlockState process(OnePole& self,
+                                    core::MutChannelView const& in_out);
+
     static void reset(OnePole& self, real in);
     static real tau_to_pole(real tau, real sample_rate);
+
+    /**
+     * @brief Returns the shared coefficients of tau and sample_rate. Not
+     * realtime safe, \sa core::CoefficientCache
+     */
+    static std::shared_ptr<OnePoleCoefficients const> intern(real tau,
+                                                             real sample_rate);
+
+    /**
+     * @brief Releases interned coefficients no filter refers to anymore
+     *
+     * @return Returns the number of released coefficient records
+     */
+    static std::size_t collect_interned();
+
+    /**
+     * @brief Processes one sample with shared coefficients
+     *
+     * @param z State of the filter
+     */
+    static real
+    process(OnePoleCoefficients const& coeffs, mut_real& z, real in);
 };
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/buffer_view.h"
+#include "ha/dsp_tool_box/core/types.h"
+#include <vector>
+
+namespace ha::dtb::filtering {
+
+/**
+ * @brief Many one-pole filters stored as structure of arrays, e.g. smoothers
+ * of all parameters of a patch. Processed with the runtime dispatched block
+ * kernels, \sa core::CpuDispatchImpl
+ */
+struct OnePoleBank final
+{
+    std::vector<mut_real> a;
+    std::vector<mut_real> b;
+    std::vector<mut_real> z;
+};
+
+struct OnePoleBankImpl final
+{
+    /**
+     * @brief Create a OnePoleBank
+     *
+     * @param num_filters Number of filters
+     * @param a Pole of all filters
+     * @return Returns a fully initialised and functional OnePoleBank
+     */
+    static OnePoleBank create(i32 num_filters, real a = 0.9);
+
+    /**
+     * @brief Sets the pole of one filter, \sa OnePoleImpl::update_pole
+     */
+    static void update_pole(OnePoleBank& self, i32 index, real a);
+
+    /**
+     * @brief Resets the state of one filter, \sa OnePoleImpl::reset
+     */
+    static void reset(OnePoleBank& self, i32 index, real in);
+
+    /**
+     * @brief Processes one sample of every filter
+     *
+     * @param in One input per filter
+     * @param out One output per filter
+     */
+    static void process(OnePoleBank& self, real const* in, mut_real* out);
+
+    /**
+     * @brief Processes num_samples frames. A frame holds one sample per filter,
+     * so in and out hold num_samples * size() interleaved samples.
+     */
+    static void process(OnePoleBank& self,
+                        real const* in,
+                        mut_real* out,
+                        i32 num_samples);
+
+    /**
+     * @brief Processes a block, one channel per filter. Interleaved frames
+     * (\sa core::BufferViewImpl::is_interleaved) use the vectorised kernels,
+     * any other layout is processed filter by filter without copying.
+     */
+    static void process(OnePoleBank& self,
+                        core::ConstBlockView const& in,
+                        core::MutBlockView const& out);
+
+    /**
+     * @brief Processes num_samples of the filter at index only. in and out
+     * may be the same buffer.
+     */
+    static void process_filter(OnePoleBank& self,
+                               i32 index,
+                               real const* in,
+                               mut_real* out,
+                               i32 num_samples);
+
+    /**
+     * @brief Processes a block of the filter at index only. in and out may
+     * view the same samples.
+     */
+    static void process_filter(OnePoleBank& self,
+                               i32 index,
+                               core::ConstChannelView const& in,
+                               core::MutChannelView const& out);
+
+    /**
+     * @brief Number of filters
+     */
+    static i32 size(OnePoleBank const& self);
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::filtering
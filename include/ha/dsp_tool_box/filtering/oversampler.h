@@ -0,0 +1,138 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/buffer_view.h"
+#include "ha/dsp_tool_box/core/types.h"
+#include <vector>
+
+namespace ha::dtb::filtering {
+
+/**
+ * @brief Runs a block processor at 2, 4 or 8 times the sample rate, e.g. a
+ * Phase driven at audio rate, to keep its sidebands from aliasing. Cascades
+ * one polyphase halfband stage per factor of 2, the branch FIRs run on the
+ * runtime dispatched block kernels, \sa core::CpuDispatchImpl
+ *
+ * All memory is allocated by create(), processing is realtime safe. One
+ * Oversampler processes one channel.
+ */
+struct Oversampler final
+{
+    static constexpr i32 MAX_FACTOR = 8;
+
+    enum class Response
+    {
+        //! Halfband filters, latency is half the filter lengths
+        LinearPhase = 0,
+        //! Same magnitude response with much lower latency, but the phase
+        //! bends near the cutoff
+        MinimumPhase
+    };
+
+    /**
+     * @brief One factor of 2. Both directions use the same two polyphase
+     * branches of the prototype filter, scaled by 2.
+     */
+    struct Stage
+    {
+        //! Taps per branch
+        mut_i32 num_taps = 0;
+        //! The odd branch of a halfband is a delay of num_taps / 2 samples
+        bool halfband = false;
+        //! Branch taps in reversed order, \sa core::BlockKernels::fir
+        std::vector<mut_real> even_taps;
+        std::vector<mut_real> odd_taps;
+
+        //! Past samples in front of the current block
+        std::vector<mut_real> up_history;
+        std::vector<mut_real> down_even_history;
+        std::vector<mut_real> down_odd_history;
+
+        std::vector<mut_real> even_out;
+        std::vector<mut_real> odd_out;
+    };
+
+    mut_i32 factor         = 1;
+    mut_i32 max_block_size = 0;
+    Response response      = Response::LinearPhase;
+    //! In samples at the base rate
+    mut_real latency = real(0.);
+    std::vector<Stage> stages;
+
+    //! Oversampled block
+    std::vector<mut_real> buffer;
+    //! Intermediate rates of the cascade
+    std::vector<mut_real> work;
+};
+
+struct OversamplerImpl final
+{
+    /**
+     * @brief Create an Oversampler. Designs the filters, not realtime safe.
+     *
+     * @param factor 1, 2, 4 or 8, 1 passes blocks through
+     * @param max_block_size Maximum number of samples per block at the base
+     * rate
+     * @param response Linear or minimum phase filters
+     * @return Returns a fully initialised and functional Oversampler
+     */
+    static Oversampler
+    create(i32 factor,
+           i32 max_block_size,
+           Oversampler::Response response = Oversampler::Response::LinearPhase);
+
+    /**
+     * @brief Clears the filter states
+     */
+    static void reset(Oversampler& self);
+
+    /**
+     * @brief Round trip latency of upsample and downsample in samples at the
+     * base rate. Can be fractional for factors 4 and 8, round it when
+     * reporting it to a host. The minimum phase latency is the group delay at
+     * DC.
+     */
+    static real latency(Oversampler const& self);
+
+    /**
+     * @brief Upsamples a block into the internal buffer
+     *
+     * @param in At most max_block_size samples
+     * @return Returns in.num_samples * factor samples. Valid until the next
+     * call, processors may change them in place.
+     */
+    static core::MutChannelView upsample(Oversampler& self,
+                                         core::ConstChannelView const& in);
+
+    /**
+     * @brief Downsamples an oversampled block
+     *
+     * @param in out.num_samples * factor samples, usually the block returned
+     * by upsample
+     */
+    static void downsample(Oversampler& self,
+                           core::ConstChannelView const& in,
+                           core::MutChannelView const& out);
+
+    /**
+     * @brief Runs processor at the oversampled rate, in and out may view the
+     * same samples
+     *
+     * @param processor Called as processor(core::MutChannelView const&) with
+     * the oversampled block, processes it in place
+     */
+    template <typename Processor>
+    static void process(Oversampler& self,
+                        core::ConstChannelView const& in,
+                        core::MutChannelView const& out,
+                        Processor&& processor)
+    {
+        auto const block = upsample(self, in);
+        processor(block);
+        downsample(self, core::BufferViewImpl::as_const(block), out);
+    }
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::filtering
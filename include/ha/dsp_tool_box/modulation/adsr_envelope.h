@@ -2,8 +2,12 @@
 
 #pragma once
 
+#include "ha/dsp_tool_box/core/block_state.h"
+#include "ha/dsp_tool_box/core/buffer_view.h"
 #include "ha/dsp_tool_box/core/types.h"
+#include <cstddef>
 #include <math.h>
+#include <memory>
 #include <utility>
 
 namespace ha::dtb::modulation {
@@ -56,21 +60,60 @@ public:
         mut_real release_value;
     };
 
+    /**
+     * @brief Describes the value of a stage as from + (to - from) * curve(x).
+     * The curve is the easing curve if eased is set, linear otherwise.
+     */
+    struct segment
+    {
+        mut_real x;
+        mut_real from;
+        mut_real to;
+        bool eased;
+    };
+
     real get_value(context& data) const;
 
+    /**
+     * @brief Like get_value but returns the segment instead of evaluating it.
+     * Lets block renderers evaluate the curves of many voices at once.
+     */
+    segment get_segment(context& data) const;
+
+    /**
+     * @brief Evaluates a segment, get_value(data) equals
+     * evaluate(get_segment(data)).
+     */
+    static real evaluate(segment const& seg);
+
     void set_att(real time_seconds) { update_value(time_seconds, att_seconds); }
     void set_dec(real time_seconds) { update_value(time_seconds, dec_seconds); }
     void set_sus(real normalized) { sus_normalized = normalized; }
     void set_rel(real time_seconds) { update_value(time_seconds, rel_seconds); }
 
+    /**
+     * @brief Returns an immutable envelope shared by all callers with the same
+     * settings. Read it with an adsr_envelope_voice. Not realtime safe,
+     * \sa core::CoefficientCache
+     */
+    static std::shared_ptr<adsr_envelope const>
+    intern(real att, real dec, real sus, real rel);
+
+    /**
+     * @brief Releases interned envelopes no voice refers to anymore
+     *
+     * @return Returns the number of released envelopes
+     */
+    static std::size_t collect_interned();
+
     //-------------------------------------------------------------------------
 private:
     void update_value(real newValue, value& value);
-    real attack(context& data) const;
-    real decay(context& data) const;
-    real sustain(context& data) const;
-    real release(context& data) const;
-    real shape(real xVal) const;
+    segment attack(context& data) const;
+    segment decay(context& data) const;
+    segment sustain(context& data) const;
+    segment release(context& data) const;
+    static real shape(real xVal);
 
     value att_seconds;
     value dec_seconds;
@@ -78,6 +121,37 @@ private:
     value rel_seconds;
 };
 
+//-----------------------------------------------------------------------------
+/**
+ * @brief The per voice state of an envelope. The settings are passed in on
+ * every read, so many voices can share one (interned) adsr_envelope.
+ */
+class adsr_envelope_voice
+{
+public:
+    //-------------------------------------------------------------------------
+    adsr_envelope_voice() = default;
+
+    void trigger();
+    real read(adsr_envelope const& adsr, real time_seconds);
+    void release();
+
+    /**
+     * @brief Reads one value per sample, the first one at time_seconds.
+     * Sustain, the time before trigger and after release are constant.
+     */
+    core::BlockState read(adsr_envelope const& adsr,
+                          real time_seconds,
+                          real sample_rate,
+                          core::MutChannelView const& out);
+
+    //-------------------------------------------------------------------------
+private:
+    adsr_envelope::context current_data = {
+        adsr_envelope::stages::STAGE_BEFORE_TRIGGER, real(0.), real(0.)};
+    mut_real current_value = real(0.);
+};
+
 //-----------------------------------------------------------------------------
 class adsr_envelope_processor
 {
@@ -89,6 +163,13 @@ public:
     real read(real time_seconds) const;
     void release();
 
+    /**
+     * @brief Reads one value per sample, the first one at time_seconds
+     */
+    core::BlockState read(real time_seconds,
+                          real sample_rate,
+                          core::MutChannelView const& out) const;
+
     void set_att(real value) { adsr.set_att(value); };
     void set_dec(real value) { adsr.set_dec(value); };
     void set_sus(real value) { adsr.set_sus(value); };
@@ -97,8 +178,7 @@ public:
     //-------------------------------------------------------------------------
 private:
     adsr_envelope adsr;
-    mutable adsr_envelope::context current_data;
-    mutable mut_real current_value = real(0.);
+    mutable adsr_envelope_voice voice;
 };
 
 //-----------------------------------------------------------------------------
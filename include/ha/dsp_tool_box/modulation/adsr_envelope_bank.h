@@ -0,0 +1,58 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#include <vector>
+
+namespace ha::dtb::modulation {
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Many voices sharing one adsr_envelope. Stage handling happens per
+ * voice, the easing curves of all voices are evaluated at once with the
+ * runtime dispatched block kernels, \sa core::CpuDispatchImpl
+ */
+class adsr_envelope_bank
+{
+public:
+    //-------------------------------------------------------------------------
+    explicit adsr_envelope_bank(i32 num_voices);
+
+    void trigger(i32 voice);
+    void release(i32 voice);
+
+    /**
+     * @brief Reads all voices, \sa adsr_envelope_voice::read
+     *
+     * @param time_seconds One time per voice since trigger or release
+     * @param out One value per voice
+     */
+    void
+    read(adsr_envelope const& adsr, real const* time_seconds, mut_real* out);
+
+    /**
+     * @brief Reads all voices from and into strided channels, e.g. one frame
+     * of interleaved buffers
+     *
+     * @param time_seconds One time per voice since trigger or release
+     * @param out One value per voice
+     */
+    void read(adsr_envelope const& adsr,
+              core::ConstChannelView const& time_seconds,
+              core::MutChannelView const& out);
+
+    i32 size() const { return static_cast<i32>(contexts.size()); }
+
+    //-------------------------------------------------------------------------
+private:
+    std::vector<adsr_envelope::context> contexts;
+    std::vector<mut_real> values;
+    std::vector<mut_real> x;
+    std::vector<mut_real> from;
+    std::vector<mut_real> to;
+    std::vector<mut_u8> eased;
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
@@ -0,0 +1,67 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#include <vector>
+
+namespace ha::dtb::modulation {
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Low memory variant of adsr_envelope_bank for very high voice
+ * counts. A voice takes 7 bytes: its stage, the samples since trigger or
+ * release and the release level as 16 bit fixed point. Counting samples
+ * instead of summing float times keeps long envelopes exact.
+ */
+class adsr_envelope_compact_bank
+{
+public:
+    //-------------------------------------------------------------------------
+    //! 1.0 in the fixed point format of the release levels
+    static constexpr u32 ONE = 0xFFFF;
+
+    explicit adsr_envelope_compact_bank(i32 num_voices);
+
+    void trigger(i32 voice);
+
+    /**
+     * @brief Releases a voice from its current value, rounded to the nearest
+     * 1/65535
+     */
+    void release(adsr_envelope const& adsr, real sample_rate, i32 voice);
+
+    /**
+     * @brief Reads the current value of all voices
+     *
+     * @param out One value per voice
+     */
+    void read(adsr_envelope const& adsr, real sample_rate, mut_real* out);
+
+    /**
+     * @brief Same as above, writes into a strided channel
+     *
+     * @param out One value per voice
+     */
+    void read(adsr_envelope const& adsr,
+              real sample_rate,
+              core::MutChannelView const& out);
+
+    /**
+     * @brief Moves all voices num_samples further
+     */
+    void advance(i32 num_samples);
+
+    i32 size() const { return static_cast<i32>(stages.size()); }
+
+    //-------------------------------------------------------------------------
+private:
+    adsr_envelope::context context_of(real sample_rate, i32 voice) const;
+
+    std::vector<mut_u8> stages;
+    std::vector<mut_u32> samples;
+    std::vector<mut_u16> release_levels;
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
@@ -0,0 +1,101 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/block_state.h"
+#include "ha/dsp_tool_box/core/buffer_view.h"
+#include "ha/dsp_tool_box/core/types.h"
+#include "ha/dsp_tool_box/filtering/one_pole_bank.h"
+#include <vector>
+
+namespace ha::dtb::modulation {
+
+/**
+ * @brief A parameter value reached at a sample offset of the current block
+ */
+struct AutomationPoint final
+{
+    mut_i32 offset = 0;
+    mut_real value = real(0.);
+};
+
+/**
+ * @brief Renders sparse host automation of many parameters to audio rate.
+ * Each lane ramps linearly from its value at the end of the previous block
+ * through the points of the current block and holds the last value. The
+ * point lists are preallocated, a lane can optionally be smoothed by a
+ * one-pole in the same pass.
+ */
+struct AutomationLanes final
+{
+    mut_i32 max_points = 0;
+    //! max_points per lane, lane after lane
+    std::vector<AutomationPoint> points;
+    std::vector<mut_i32> num_points;
+    //! Value of each lane at the end of the previous block
+    std::vector<mut_real> values;
+    //! Smoother of each lane, a pole of 0 disables smoothing
+    filtering::OnePoleBank smoothers;
+};
+
+struct AutomationLanesImpl final
+{
+    /**
+     * @brief Create AutomationLanes
+     *
+     * @param num_lanes Number of automated parameters
+     * @param max_points Maximum number of points per lane and block
+     * @return Returns fully initialised AutomationLanes without smoothing
+     */
+    static AutomationLanes create(i32 num_lanes, i32 max_points);
+
+    /**
+     * @brief Sets the value of a lane immediately, without a ramp
+     */
+    static void set_value(AutomationLanes& self, i32 lane, real value);
+
+    /**
+     * @brief Adds a point to the current block. Offsets of a lane must not
+     * decrease, of several points at the same offset the last one wins.
+     * Realtime safe.
+     *
+     * @param offset Sample offset in [0, num_samples - 1] of the next render,
+     * larger offsets are clamped to the last sample
+     *
+     * @return Returns false if the point list of the lane is full
+     */
+    static bool
+    add_point(AutomationLanes& self, i32 lane, i32 offset, real value);
+
+    /**
+     * @brief Sets the smoothing pole of a lane, \sa OnePoleImpl::tau_to_pole.
+     * A pole of 0 disables smoothing.
+     */
+    static void set_smoothing(AutomationLanes& self, i32 lane, real a);
+
+    /**
+     * @brief Renders all lanes and clears their points. Lanes without points
+     * and a settled smoother are filled with their constant value.
+     *
+     * @param out Destination of size() * num_samples values, lane after lane
+     */
+    static void
+    render(AutomationLanes& self, mut_real* out, i32 num_samples);
+
+    /**
+     * @brief Renders all lanes into a block view, one channel per lane
+     *
+     * @param states Receives one state per lane if not nullptr
+     */
+    static void render(AutomationLanes& self,
+                       core::MutBlockView const& out,
+                       core::BlockState* states = nullptr);
+
+    /**
+     * @brief Number of lanes
+     */
+    static i32 size(AutomationLanes const& self);
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
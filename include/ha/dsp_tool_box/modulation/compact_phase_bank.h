@@ -0,0 +1,108 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/buffer_view.h"
+#include "ha/dsp_tool_box/core/types.h"
+#include "ha/dsp_tool_box/modulation/modulation_phase.h"
+#include <vector>
+
+namespace ha::dtb::modulation {
+
+/**
+ * @brief Low memory variant of PhaseBank for very high voice counts, e.g.
+ * granular or unison engines. A phase takes 4 bytes: a 16 bit fixed point
+ * value, the index of its shared increment group and an overflow flag.
+ *
+ * The increments live in up to MAX_GROUPS shared groups with 32 bit
+ * precision. Each group carries the fraction below the 16 bit value once
+ * for all of its phases, so the rate does not drift. Phases of a group
+ * always advance by the same amount.
+ */
+struct CompactPhaseBank final
+{
+    static constexpr i32 MAX_GROUPS = 256;
+    //! 1.0 in the fixed point format of values
+    static constexpr u32 ONE = 1u << 16;
+
+    //! Phase in [0, 1) as value / ONE
+    std::vector<mut_u16> values;
+    std::vector<mut_u8> groups;
+    //! 1 if the phase overflowed during the last advance
+    std::vector<mut_u8> overflows;
+
+    //! Shared increment per sample of each group, 1.0 is 2^32
+    std::vector<mut_u32> increments;
+    //! Shared fraction below one step of values of each group, 1.0 is 2^32
+    std::vector<mut_u32> residues;
+};
+
+struct CompactPhaseBankImpl final
+{
+    /**
+     * @brief Create a CompactPhaseBank
+     *
+     * @param num_phases Number of phases, all starting at 0 in group 0
+     * @param num_groups Number of shared increments, at most MAX_GROUPS
+     * @return Returns a fully initialised CompactPhaseBank, all increments
+     * are 0
+     */
+    static CompactPhaseBank create(i32 num_phases, i32 num_groups = 1);
+
+    /**
+     * @brief Takes over the increment of phase, \sa PhaseImpl::increment
+     */
+    static void
+    set_group_phase(CompactPhaseBank& self, i32 group, Phase const& phase);
+
+    /**
+     * @brief Sets the shared increment per sample of a group
+     */
+    static void
+    set_group_increment(CompactPhaseBank& self, i32 group, real increment);
+
+    /**
+     * @brief Moves a phase to a group
+     */
+    static void set_group(CompactPhaseBank& self, i32 index, i32 group);
+
+    /**
+     * @brief Sets the value of one phase, rounded to the nearest 1/65536
+     */
+    static void set_value(CompactPhaseBank& self, i32 index, real value);
+
+    /**
+     * @brief Value of one phase. The conversion is exact, set_value with the
+     * result restores the same state.
+     */
+    static real value(CompactPhaseBank const& self, i32 index);
+
+    /**
+     * @brief Advances all phases. When overflown they start at 0 again and
+     * their overflows entry is set, \sa PhaseBankImpl::advance
+     */
+    static void advance(CompactPhaseBank& self, i32 num_samples);
+
+    /**
+     * @brief Converts all values to float
+     *
+     * @param out One value per phase
+     */
+    static void read(CompactPhaseBank const& self, mut_real* out);
+
+    /**
+     * @brief Same as above, writes into a strided channel
+     *
+     * @param out One value per phase
+     */
+    static void read(CompactPhaseBank const& self,
+                     core::MutChannelView const& out);
+
+    /**
+     * @brief Number of phases
+     */
+    static i32 size(CompactPhaseBank const& self);
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
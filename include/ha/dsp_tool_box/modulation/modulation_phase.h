@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "ha/dsp_tool_box/core/block_state.h"
+#include "ha/dsp_tool_box/core/buffer_view.h"
 #include "ha/dsp_tool_box/core/types.h"
 
 namespace ha::dtb::modulation {
@@ -60,6 +62,37 @@ struct PhaseImpl final
      */
     static bool advance(Phase const& self, mut_real& value, i32 num_samples);
 
+    /**
+     * @brief Advances the phase value by out.num_samples and writes the phase
+     * of every sample to out.
+     *
+     * @param value Current phase value
+     * @param out Receives the phase at each sample, starting with value
+     * @return Returns true on overflow
+     */
+    static bool advance(Phase const& self,
+                        mut_real& value,
+                        core::MutChannelView const& out);
+
+    /**
+     * @brief Same as above, state receives Constant if the phase does not
+     * move within the block, e.g. a rate of 0 or ProjectSync
+     */
+    static bool advance(Phase const& self,
+                        mut_real& value,
+                        core::MutChannelView const& out,
+                        core::BlockState& state);
+
+    /**
+     * @brief Phase increment per sample of the current sync mode. Use it to
+     * advance the phase sample by sample, e.g. for an audio rate oscillator.
+     * In ProjectSync mode it is the speed of the transport only, the phase
+     * itself must be taken from the project time once per block.
+     *
+     * @return Returns the increment per sample
+     */
+    static real increment(Phase const& self);
+
     /**
      * @brief Sets the sync mode of Phase
      *
@@ -0,0 +1,208 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/block_state.h"
+#include "ha/dsp_tool_box/core/buffer_view.h"
+#include "ha/dsp_tool_box/core/types.h"
+#include <array>
+#include <vector>
+
+namespace ha::dtb::modulation {
+
+/**
+ * @brief Curve of an MsegSegment
+ */
+enum class MsegCurve
+{
+    //! Straight line from the previous level to the level
+    Linear = 0,
+    //! easing::ease_virus_ti from the previous level to the level
+    Ease,
+    //! Jumps to the level and keeps it, e.g. for delay and hold stages
+    Hold
+};
+
+/**
+ * @brief One breakpoint of an Mseg. The segment runs from the level of the
+ * previous segment (or Mseg::start_level) to its level.
+ */
+struct MsegSegment final
+{
+    mut_real duration_seconds = real(0.);
+    mut_real level            = real(0.);
+    MsegCurve curve           = MsegCurve::Linear;
+};
+
+/**
+ * @brief Settings of a multi-segment envelope, shareable by many voices. The
+ * segment table is flat and preallocated, coefficients are computed whenever
+ * a segment or the sample rate changes.
+ *
+ * While the gate is on, the envelope loops from loop_end back to loop_begin
+ * (if set) or holds at the end of sustain_segment (if set). Releasing jumps to
+ * release_segment which starts at the current value.
+ */
+struct Mseg final
+{
+    static constexpr i32 MAX_SEGMENTS = 32;
+    static constexpr i32 NONE         = -1;
+
+    /**
+     * @brief Per segment coefficients for the recursive rendering
+     */
+    struct Coefficients
+    {
+        double num_samples = 0.;
+        double x_increment = 0.;
+        //! 2^(-multiplicator * x_increment), the ease state per sample
+        double ease_ratio = 1.;
+    };
+
+    std::array<MsegSegment, MAX_SEGMENTS> segments{};
+    std::array<Coefficients, MAX_SEGMENTS> coefficients{};
+    mut_i32 num_segments    = 0;
+    mut_i32 sustain_segment = NONE;
+    mut_i32 loop_begin      = NONE;
+    mut_i32 loop_end        = NONE;
+    mut_i32 release_segment = NONE;
+    mut_real start_level    = real(0.);
+    mut_real sample_rate    = real(44100.);
+};
+
+/**
+ * @brief Per voice state of an Mseg
+ */
+struct MsegVoice final
+{
+    mut_i32 segment = Mseg::NONE;
+    //! Samples since the start of the segment
+    double position = 0.;
+    //! 2^(-multiplicator * x) of Ease segments
+    double ease_state = 1.;
+    mut_real from     = real(0.);
+    mut_real value    = real(0.);
+    bool gate         = false;
+    bool holding      = true;
+};
+
+struct MsegImpl final
+{
+    /**
+     * @brief Create an Mseg without segments
+     */
+    static Mseg create(real sample_rate = real(44100.));
+
+    /**
+     * @brief Create an Mseg which renders like adsr_envelope, sample n of the
+     * rendered block equals adsr_envelope_processor::read(n / sample_rate)
+     * apart from float rounding.
+     */
+    static Mseg create_adsr(
+        real att, real dec, real sus, real rel, real sample_rate);
+
+    /**
+     * @brief Sets a segment and computes its coefficients
+     */
+    static void set_segment(Mseg& self, i32 index, MsegSegment const& segment);
+
+    /**
+     * @brief Sets the number of used segments, at most MAX_SEGMENTS
+     */
+    static void set_num_segments(Mseg& self, i32 value);
+
+    /**
+     * @brief Holds at the end of segment while the gate is on
+     */
+    static void set_sustain_segment(Mseg& self, i32 index);
+
+    /**
+     * @brief Loops from the end of loop_end to the start of loop_begin while
+     * the gate is on. Overrides the sustain segment.
+     */
+    static void set_loop(Mseg& self, i32 loop_begin, i32 loop_end);
+
+    /**
+     * @brief First segment after the gate went off
+     */
+    static void set_release_segment(Mseg& self, i32 index);
+
+    /**
+     * @brief Sets the sample rate and computes all coefficients
+     */
+    static void set_sample_rate(Mseg& self, real value);
+
+    /**
+     * @brief Starts the first segment at start_level
+     */
+    static void trigger(Mseg const& self, MsegVoice& voice);
+
+    /**
+     * @brief Starts the release segment at the current value
+     */
+    static void release(Mseg const& self, MsegVoice& voice);
+
+    /**
+     * @brief Renders a block. Segment changes are handled once per segment
+     * and not per sample.
+     *
+     * @param out Destination of num_samples values
+     * @return Returns Constant while the voice holds a level
+     */
+    static core::BlockState render(Mseg const& self,
+                                   MsegVoice& voice,
+                                   mut_real* out,
+                                   i32 num_samples);
+
+    /**
+     * @brief Renders out.num_samples values into a strided channel view
+     */
+    static core::BlockState render(Mseg const& self,
+                                   MsegVoice& voice,
+                                   core::MutChannelView const& out);
+};
+
+/**
+ * @brief Many voices sharing one Mseg
+ */
+struct MsegBank final
+{
+    std::vector<MsegVoice> voices;
+};
+
+struct MsegBankImpl final
+{
+    /**
+     * @brief Create a MsegBank with num_voices idle voices
+     */
+    static MsegBank create(i32 num_voices);
+
+    static void trigger(Mseg const& mseg, MsegBank& self, i32 voice);
+    static void release(Mseg const& mseg, MsegBank& self, i32 voice);
+
+    /**
+     * @brief Renders a block of all voices
+     *
+     * @param out Destination of size() * num_samples values, voice after
+     * voice
+     */
+    static void render(Mseg const& mseg,
+                       MsegBank& self,
+                       mut_real* out,
+                       i32 num_samples);
+
+    /**
+     * @brief Renders a block of all voices, one channel per voice
+     *
+     * @param states Receives one state per voice if not nullptr
+     */
+    static void render(Mseg const& mseg,
+                       MsegBank& self,
+                       core::MutBlockView const& out,
+                       core::BlockState* states = nullptr);
+
+    static i32 size(MsegBank const& self);
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
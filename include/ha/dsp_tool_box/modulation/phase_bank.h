@@ -0,0 +1,65 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/types.h"
+#include "ha/dsp_tool_box/modulation/modulation_phase.h"
+#include <vector>
+
+namespace ha::dtb::modulation {
+
+/**
+ * @brief Many phase values advanced at once, e.g. the LFOs of all voices.
+ * Every phase runs with the increment of a Phase in Free or TempoSync mode.
+ * Processed with the runtime dispatched block kernels,
+ * \sa core::CpuDispatchImpl
+ */
+struct PhaseBank final
+{
+    std::vector<mut_real> values;
+    std::vector<mut_real> increments;
+    //! 1 if the phase overflowed during the last advance
+    std::vector<mut_u8> overflows;
+};
+
+struct PhaseBankImpl final
+{
+    /**
+     * @brief Create a PhaseBank
+     *
+     * @param num_phases Number of phases, all starting at 0
+     * @return Returns a fully initialised PhaseBank, all increments are 0
+     */
+    static PhaseBank create(i32 num_phases);
+
+    /**
+     * @brief Takes over the increment of phase, \sa PhaseImpl::increment
+     */
+    static void set_phase(PhaseBank& self, i32 index, Phase const& phase);
+
+    /**
+     * @brief Sets the increment per sample of one phase
+     */
+    static void set_increment(PhaseBank& self, i32 index, real increment);
+
+    /**
+     * @brief Sets the value of one phase, e.g. on note on
+     */
+    static void set_value(PhaseBank& self, i32 index, real value);
+
+    /**
+     * @brief Advances all phases. When overflown they start at 0 again and
+     * their overflows entry is set, \sa PhaseImpl::advance
+     *
+     * @param num_samples Number of samples to advance
+     */
+    static void advance(PhaseBank& self, i32 num_samples);
+
+    /**
+     * @brief Number of phases
+     */
+    static i32 size(PhaseBank const& self);
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
@@ -0,0 +1,128 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/types.h"
+#include "ha/dsp_tool_box/modulation/modulation_phase.h"
+#include <memory>
+#include <vector>
+
+namespace ha::dtb::synthesis {
+
+/**
+ * @brief Waveforms available as band-limited wavetables
+ */
+enum class Waveform
+{
+    Sine = 0,
+    Saw,
+    Square,
+    Triangle,
+    Count
+};
+
+/**
+ * @brief Immutable, mipmapped and band-limited single cycle waveform. Level 0
+ * holds MAX_HARMONICS partials, every following level half as many. Each
+ * level carries one guard sample for interpolation.
+ */
+struct Wavetable final
+{
+    static constexpr i32 TABLE_SIZE    = 4096;
+    static constexpr i32 LEVEL_SIZE    = TABLE_SIZE + 1;
+    static constexpr i32 NUM_LEVELS    = 11;
+    static constexpr i32 MAX_HARMONICS = 1 << (NUM_LEVELS - 1);
+
+    Waveform waveform = Waveform::Sine;
+    std::vector<mut_real> samples;
+};
+
+struct WavetableCache final
+{
+    /**
+     * @brief Returns the wavetable of a waveform. Tables are computed on first
+     * use and shared by all oscillators afterwards. Not realtime safe on first
+     * use, call e.g. while creating the oscillators.
+     *
+     * @param waveform \sa Waveform
+     */
+    static std::shared_ptr<Wavetable const> get(Waveform waveform);
+};
+
+/**
+ * @brief A band-limited oscillator reading a shared Wavetable. It holds no
+ * phase of its own but consumes the output of a Phase.
+ */
+struct WavetableOscillator final
+{
+    std::shared_ptr<Wavetable const> table;
+};
+
+struct WavetableOscillatorImpl final
+{
+    /**
+     * @brief Create a WavetableOscillator
+     *
+     * @param waveform \sa Waveform
+     * @return Returns a fully initialised and functional WavetableOscillator
+     */
+    static WavetableOscillator create(Waveform waveform = Waveform::Saw);
+
+    /**
+     * @brief Sets the waveform of WavetableOscillator
+     *
+     * @param waveform \sa Waveform
+     */
+    static void set_waveform(WavetableOscillator& self, Waveform waveform);
+
+    /**
+     * @brief Selects the mipmap level which keeps all partials below Nyquist
+     *
+     * @param increment Phase increment per sample, e.g. frequency/sample_rate
+     * @return Returns the level index
+     */
+    static i32 select_level(real increment);
+
+    /**
+     * @brief Reads one sample
+     *
+     * @param phase Phase value in the range [0, 1)
+     * @param increment Phase increment per sample
+     * @return Returns the interpolated sample
+     */
+    static real process(WavetableOscillator const& self,
+                        real phase,
+                        real increment);
+
+    /**
+     * @brief Renders a block from precomputed phase values, e.g. the output of
+     * several Phases advanced per sample.
+     *
+     * @param phases Phase values in the range [0, 1)
+     * @param increment Phase increment per sample used to select the level
+     * @param out Destination of num_samples samples
+     */
+    static void render(WavetableOscillator const& self,
+                       real const* phases,
+                       real increment,
+                       mut_real* out,
+                       i32 num_samples);
+
+    /**
+     * @brief Advances a Phase sample by sample and renders a block
+     *
+     * @param phase The Phase driving the oscillator, a negative rate plays
+     * the table backwards. In ProjectSync mode value is first set from the
+     * project time.
+     * @param value Current phase value, advanced by num_samples
+     * @param out Destination of num_samples samples
+     */
+    static void render(WavetableOscillator const& self,
+                       modulation::Phase const& phase,
+                       mut_real& value,
+                       mut_real* out,
+                       i32 num_samples);
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::synthesis
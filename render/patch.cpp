@@ -0,0 +1,175 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "patch.h"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace ha::dtb::render {
+namespace {
+
+//-----------------------------------------------------------------------------
+bool parse_shape(std::string const& name, Patch::Shape& shape)
+{
+    constexpr char const* NAMES[] = {"sine", "triangle", "saw", "square"};
+    for (int i = 0; i < 4; ++i)
+    {
+        if (name == NAMES[i])
+        {
+            shape = static_cast<Patch::Shape>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+i32 find_smoother(Patch const& patch, std::string const& name)
+{
+    for (size_t i = 0; i < patch.smoothers.size(); ++i)
+    {
+        if (patch.smoothers[i].name == name)
+            return static_cast<i32>(i);
+    }
+    return -1;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Parses one statement, returns the reason on failure.
+ */
+std::string parse_statement(std::istringstream& line, Patch& patch)
+{
+    std::string keyword;
+    line >> keyword;
+
+    if (keyword == "sample_rate")
+    {
+        if (!(line >> patch.sample_rate) || patch.sample_rate <= real(0.))
+            return "expected a positive sample rate";
+    }
+    else if (keyword == "block_size")
+    {
+        if (!(line >> patch.block_size) || patch.block_size <= 0)
+            return "expected a positive block size";
+    }
+    else if (keyword == "duration")
+    {
+        if (!(line >> patch.duration) || patch.duration < 0.)
+            return "expected a duration in seconds";
+    }
+    else if (keyword == "voices")
+    {
+        if (!(line >> patch.num_voices) || patch.num_voices <= 0)
+            return "expected a positive number of voices";
+    }
+    else if (keyword == "envelope")
+    {
+        Patch::Envelope envelope;
+        if (!(line >> envelope.name >> envelope.att >> envelope.dec >>
+              envelope.sus >> envelope.rel))
+            return "expected envelope <name> <att> <dec> <sus> <rel>";
+        patch.envelopes.push_back(envelope);
+    }
+    else if (keyword == "lfo")
+    {
+        Patch::Lfo lfo{"", real(1.), Patch::Shape::Sine};
+        if (!(line >> lfo.name >> lfo.rate_hz))
+            return "expected lfo <name> <rate_hz> [shape]";
+
+        std::string shape;
+        if (line >> shape && !parse_shape(shape, lfo.shape))
+            return "unknown lfo shape '" + shape + "'";
+        patch.lfos.push_back(lfo);
+    }
+    else if (keyword == "smoother")
+    {
+        Patch::Smoother smoother{"", real(0.), real(0.)};
+        if (!(line >> smoother.name >> smoother.tau_seconds))
+            return "expected smoother <name> <tau_seconds> [initial]";
+
+        line >> smoother.initial;
+        patch.smoothers.push_back(smoother);
+    }
+    else if (keyword == "note")
+    {
+        Patch::Note note;
+        if (!(line >> note.on_seconds >> note.off_seconds) ||
+            note.off_seconds < note.on_seconds)
+            return "expected note <on_seconds> <off_seconds>";
+        patch.notes.push_back(note);
+    }
+    else if (keyword == "target")
+    {
+        std::string name;
+        Patch::Target target;
+        if (!(line >> name >> target.seconds >> target.value))
+            return "expected target <smoother_name> <seconds> <value>";
+
+        target.smoother = find_smoother(patch, name);
+        if (target.smoother < 0)
+            return "unknown smoother '" + name + "'";
+        patch.targets.push_back(target);
+    }
+    else
+    {
+        return "unknown statement '" + keyword + "'";
+    }
+
+    return {};
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool PatchImpl::load(char const* path, Patch& patch, std::string& error)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        error = std::string(path) + ": cannot open";
+        return false;
+    }
+
+    std::string text;
+    for (int number = 1; std::getline(file, text); ++number)
+    {
+        text = text.substr(0, text.find('#'));
+        if (text.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        std::istringstream line(text);
+        std::string const reason = parse_statement(line, patch);
+        if (!reason.empty())
+        {
+            error = std::string(path) + ":" + std::to_string(number) + ": " +
+                    reason;
+            return false;
+        }
+    }
+
+    if (num_channels(patch) == 0)
+    {
+        error = std::string(path) + ": no envelope, lfo or smoother";
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+i32 PatchImpl::num_channels(Patch const& patch)
+{
+    return static_cast<i32>(patch.envelopes.size() + patch.lfos.size() +
+                            patch.smoothers.size());
+}
+
+//-----------------------------------------------------------------------------
+i32 PatchImpl::num_frames(Patch const& patch)
+{
+    return static_cast<i32>(std::lround(patch.duration * patch.sample_rate));
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::render
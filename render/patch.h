@@ -0,0 +1,110 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/types.h"
+#include <string>
+#include <vector>
+
+namespace ha::dtb::render {
+
+/**
+ * @brief Modulation patch rendered by dsp-tool-box_render. Every envelope,
+ * LFO and smoother becomes one channel of the output file, in that order.
+ *
+ * Patch files hold one statement per line, '#' starts a comment:
+ *
+ *     sample_rate <hz>
+ *     block_size <samples>
+ *     duration <seconds>
+ *     voices <count>
+ *     envelope <name> <attack> <decay> <sustain> <release>
+ *     lfo <name> <rate_hz> [sine|triangle|saw|square]
+ *     smoother <name> <tau_seconds> [initial_value]
+ *     note <on_seconds> <off_seconds>
+ *     target <smoother_name> <seconds> <value>
+ *
+ * Notes go to the voices round robin, an envelope channel is the sum of all
+ * its voices. Targets step the input of a smoother.
+ */
+struct Patch final
+{
+    enum class Shape
+    {
+        Sine = 0,
+        Triangle,
+        Saw,
+        Square
+    };
+
+    struct Envelope
+    {
+        std::string name;
+        mut_real att;
+        mut_real dec;
+        mut_real sus;
+        mut_real rel;
+    };
+
+    struct Lfo
+    {
+        std::string name;
+        mut_real rate_hz;
+        Shape shape;
+    };
+
+    struct Smoother
+    {
+        std::string name;
+        mut_real tau_seconds;
+        mut_real initial;
+    };
+
+    struct Note
+    {
+        double on_seconds;
+        double off_seconds;
+    };
+
+    struct Target
+    {
+        mut_i32 smoother;
+        double seconds;
+        mut_real value;
+    };
+
+    mut_real sample_rate = real(48000.);
+    mut_i32 block_size   = 64;
+    double duration      = 1.;
+    mut_i32 num_voices   = 8;
+
+    std::vector<Envelope> envelopes;
+    std::vector<Lfo> lfos;
+    std::vector<Smoother> smoothers;
+    std::vector<Note> notes;
+    std::vector<Target> targets;
+};
+
+struct PatchImpl final
+{
+    /**
+     * @brief Reads a patch file
+     *
+     * @param error Receives file, line and reason if parsing fails
+     * @return Returns false if the file cannot be read or is invalid
+     */
+    static bool load(char const* path, Patch& patch, std::string& error);
+
+    /**
+     * @brief Number of output channels
+     */
+    static i32 num_channels(Patch const& patch);
+
+    /**
+     * @brief Number of frames to render
+     */
+    static i32 num_frames(Patch const& patch);
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::render
@@ -0,0 +1,464 @@
+// Copyright(c) 2021 Hansen Audio.
+
+/**
+ * @brief Offline renderer of modulation patches, e.g. for regression tests
+ * and batch bouncing without a plugin host.
+ *
+ * Renders every patch into a 32 bit float WAV file of the same name with one
+ * channel per envelope, LFO and smoother, \sa render::Patch. Patches are
+ * rendered in parallel. The report lists the realtime factor per file and the
+ * throughput of every stage in samples per second.
+ *
+ * Usage: dsp-tool-box_render [--jobs <n>] [--out <dir>] [--isa <name>]
+ *                            <patch>...
+ */
+
+#include "patch.h"
+#include "wav_writer.h"
+#include "ha/dsp_tool_box/core/cpu_dispatch.h"
+#include "ha/dsp_tool_box/filtering/one_pole.h"
+#include "ha/dsp_tool_box/modulation/modulation_phase.h"
+#include "ha/dsp_tool_box/modulation/mseg_envelope.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ha::dtb;
+using render::Patch;
+using render::PatchImpl;
+
+namespace {
+
+//-----------------------------------------------------------------------------
+enum Stage
+{
+    STAGE_ENVELOPES = 0,
+    STAGE_LFOS,
+    STAGE_SMOOTHERS,
+    STAGE_WRITER,
+    NUM_STAGES
+};
+
+constexpr char const* STAGE_NAMES[NUM_STAGES] = {"envelopes", "lfos",
+                                                 "smoothers", "writer"};
+
+constexpr double PI = 3.14159265358979323846;
+
+using Clock = std::chrono::steady_clock;
+
+//-----------------------------------------------------------------------------
+struct Report
+{
+    std::string patch;
+    std::string output;
+    std::string error;
+    double duration                  = 0.;
+    double seconds                   = 0.;
+    double stage_seconds[NUM_STAGES] = {};
+    //! Samples of all channels of a stage
+    double stage_samples[NUM_STAGES] = {};
+};
+
+//-----------------------------------------------------------------------------
+struct Event
+{
+    enum class Kind
+    {
+        NoteOff = 0,
+        NoteOn,
+        Target
+    };
+
+    mut_i32 frame;
+    Kind kind;
+    mut_i32 index;
+};
+
+//-----------------------------------------------------------------------------
+/**
+ * All state and buffers of one patch, allocated before rendering starts.
+ */
+struct Renderer
+{
+    explicit Renderer(Patch const& patch)
+    : patch(patch)
+    , num_channels(PatchImpl::num_channels(patch))
+    , block_size(patch.block_size)
+    {
+    }
+
+    Patch const& patch;
+    i32 num_channels;
+    i32 block_size;
+
+    std::vector<modulation::Mseg> msegs;
+    std::vector<modulation::MsegBank> banks;
+    //! Note playing on each voice, -1 if none
+    std::vector<mut_i32> voice_notes;
+    std::vector<modulation::Phase> phases;
+    std::vector<mut_real> phase_values;
+    std::vector<filtering::OnePole> smoothers;
+    std::vector<mut_real> smoother_targets;
+
+    std::vector<Event> events;
+    std::vector<mut_real> voice_buffer;
+    std::vector<mut_real> channel_buffer;
+};
+
+//-----------------------------------------------------------------------------
+i32 to_frame(Patch const& patch, double seconds)
+{
+    return static_cast<i32>(std::lround(seconds * patch.sample_rate));
+}
+
+//-----------------------------------------------------------------------------
+void setup(Renderer& self)
+{
+    Patch const& patch = self.patch;
+    for (auto const& envelope : patch.envelopes)
+    {
+        self.msegs.push_back(modulation::MsegImpl::create_adsr(
+            envelope.att, envelope.dec, envelope.sus, envelope.rel,
+            patch.sample_rate));
+        self.banks.push_back(
+            modulation::MsegBankImpl::create(patch.num_voices));
+    }
+    self.voice_notes.assign(static_cast<size_t>(patch.num_voices), -1);
+
+    for (auto const& lfo : patch.lfos)
+    {
+        auto phase = modulation::PhaseImpl::create();
+        modulation::PhaseImpl::set_sample_rate(phase, patch.sample_rate);
+        modulation::PhaseImpl::set_sync_mode(phase,
+                                             modulation::Phase::SyncMode::Free);
+        modulation::PhaseImpl::set_rate(phase, lfo.rate_hz);
+        self.phases.push_back(phase);
+        self.phase_values.push_back(real(0.));
+    }
+
+    for (auto const& smoother : patch.smoothers)
+    {
+        real const pole = filtering::OnePoleImpl::tau_to_pole(
+            smoother.tau_seconds, patch.sample_rate);
+        auto one_pole = filtering::OnePoleImpl::create(pole);
+        filtering::OnePoleImpl::reset(one_pole, smoother.initial);
+        self.smoothers.push_back(one_pole);
+        self.smoother_targets.push_back(smoother.initial);
+    }
+
+    for (size_t i = 0; i < patch.notes.size(); ++i)
+    {
+        auto const& note = patch.notes[i];
+        auto const index = static_cast<i32>(i);
+        self.events.push_back({to_frame(patch, note.on_seconds),
+                               Event::Kind::NoteOn, index});
+        self.events.push_back({to_frame(patch, note.off_seconds),
+                               Event::Kind::NoteOff, index});
+    }
+    for (size_t i = 0; i < patch.targets.size(); ++i)
+    {
+        self.events.push_back({to_frame(patch, patch.targets[i].seconds),
+                               Event::Kind::Target, static_cast<i32>(i)});
+    }
+    // Releases first, so a voice freed at a frame can be retriggered there.
+    std::stable_sort(self.events.begin(), self.events.end(),
+                     [](Event const& lhs, Event const& rhs) {
+                         return lhs.frame != rhs.frame
+                                    ? lhs.frame < rhs.frame
+                                    : lhs.kind < rhs.kind;
+                     });
+
+    auto const block = static_cast<size_t>(self.block_size);
+    self.voice_buffer.assign(block * patch.num_voices, real(0.));
+    self.channel_buffer.assign(block * self.num_channels, real(0.));
+}
+
+//-----------------------------------------------------------------------------
+void apply(Renderer& self, Event const& event)
+{
+    Patch const& patch = self.patch;
+    i32 const voice    = event.index % patch.num_voices;
+    switch (event.kind)
+    {
+        case Event::Kind::NoteOn:
+            self.voice_notes[voice] = event.index;
+            for (size_t e = 0; e < self.msegs.size(); ++e)
+                modulation::MsegBankImpl::trigger(self.msegs[e],
+                                                  self.banks[e], voice);
+            break;
+        case Event::Kind::NoteOff:
+            // A later note may have taken over the voice.
+            if (self.voice_notes[voice] != event.index)
+                break;
+            self.voice_notes[voice] = -1;
+            for (size_t e = 0; e < self.msegs.size(); ++e)
+                modulation::MsegBankImpl::release(self.msegs[e],
+                                                  self.banks[e], voice);
+            break;
+        case Event::Kind::Target: {
+            auto const& target = patch.targets[event.index];
+            self.smoother_targets[target.smoother] = target.value;
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+real shape(Patch::Shape shape, real phase)
+{
+    switch (shape)
+    {
+        case Patch::Shape::Triangle:
+            return real(1.) - real(4.) * std::abs(phase - real(0.5));
+        case Patch::Shape::Saw:
+            return real(2.) * phase - real(1.);
+        case Patch::Shape::Square:
+            return phase < real(0.5) ? real(1.) : real(-1.);
+        case Patch::Shape::Sine:
+        default:
+            return static_cast<real>(std::sin(2. * PI * phase));
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Renders num frames starting at offset within the block into all channels.
+ */
+void render_frames(Renderer& self, i32 offset, i32 num, Report& report)
+{
+    using core::BufferViewImpl;
+
+    Patch const& patch      = self.patch;
+    mut_i32 channel         = 0;
+    auto const channel_view = [&](i32 index) {
+        return BufferViewImpl::channel(
+            self.channel_buffer.data() + index * self.block_size + offset,
+            num);
+    };
+    auto const measure = [&](Stage stage, auto const& start, i32 channels) {
+        std::chrono::duration<double> const seconds = Clock::now() - start;
+        report.stage_seconds[stage] += seconds.count();
+        report.stage_samples[stage] += static_cast<double>(num) * channels;
+    };
+
+    auto start = Clock::now();
+    for (size_t e = 0; e < self.msegs.size(); ++e, ++channel)
+    {
+        auto& bank = self.banks[e];
+        modulation::MsegBankImpl::render(self.msegs[e], bank,
+                                         self.voice_buffer.data(), num);
+        auto const out = channel_view(channel);
+        BufferViewImpl::fill(out, real(0.));
+        for (mut_i32 v = 0; v < patch.num_voices; ++v)
+        {
+            real const* voice = self.voice_buffer.data() + v * num;
+            for (mut_i32 i = 0; i < num; ++i)
+                out.data[i] += voice[i];
+        }
+    }
+    measure(STAGE_ENVELOPES, start, static_cast<i32>(self.msegs.size()));
+
+    start = Clock::now();
+    for (size_t l = 0; l < self.phases.size(); ++l, ++channel)
+    {
+        auto const out = channel_view(channel);
+        modulation::PhaseImpl::advance(self.phases[l], self.phase_values[l],
+                                       out);
+        for (mut_i32 i = 0; i < num; ++i)
+            out.data[i] = shape(patch.lfos[l].shape, out.data[i]);
+    }
+    measure(STAGE_LFOS, start, static_cast<i32>(self.phases.size()));
+
+    start = Clock::now();
+    for (size_t s = 0; s < self.smoothers.size(); ++s, ++channel)
+    {
+        // A constant input is not read, out can stand in for it.
+        auto const out = channel_view(channel);
+        filtering::OnePoleImpl::process(
+            self.smoothers[s], BufferViewImpl::as_const(out),
+            core::BlockStateImpl::constant(self.smoother_targets[s]), out);
+    }
+    measure(STAGE_SMOOTHERS, start, static_cast<i32>(self.smoothers.size()));
+}
+
+//-----------------------------------------------------------------------------
+void render_patch(char const* path, std::string const& out_dir, Report& report)
+{
+    report.patch = path;
+
+    Patch patch;
+    if (!PatchImpl::load(path, patch, report.error))
+        return;
+
+    // <out_dir>/<patch file name without extension>.wav
+    std::string name = path;
+    name             = name.substr(name.find_last_of("/\\") + 1);
+    name             = name.substr(0, name.find_last_of('.'));
+    report.output    = out_dir + "/" + name + ".wav";
+    report.duration  = patch.duration;
+
+    Renderer self(patch);
+    setup(self);
+
+    render::WavWriter writer(self.num_channels, patch.sample_rate);
+    if (!writer.open(report.output.c_str()))
+    {
+        report.error = report.output + ": cannot create";
+        return;
+    }
+
+    auto const begin  = Clock::now();
+    i32 const total   = PatchImpl::num_frames(patch);
+    size_t next_event = 0;
+    for (mut_i32 frame = 0; frame < total; frame += self.block_size)
+    {
+        i32 const num = std::min(self.block_size, total - frame);
+
+        // Sample accurate events: split the block at every event.
+        mut_i32 offset = 0;
+        while (offset < num)
+        {
+            while (next_event < self.events.size() &&
+                   self.events[next_event].frame <= frame + offset)
+                apply(self, self.events[next_event++]);
+
+            mut_i32 end = num;
+            if (next_event < self.events.size())
+                end = std::min(end, self.events[next_event].frame - frame);
+            render_frames(self, offset, end - offset, report);
+            offset = end;
+        }
+
+        auto const start = Clock::now();
+        auto const block = core::BufferViewImpl::contiguous(
+            static_cast<real const*>(self.channel_buffer.data()),
+            self.num_channels, self.block_size);
+        writer.write(core::BufferViewImpl::sub_range(block, 0, num));
+        std::chrono::duration<double> const seconds = Clock::now() - start;
+        report.stage_seconds[STAGE_WRITER] += seconds.count();
+        report.stage_samples[STAGE_WRITER] +=
+            static_cast<double>(num) * self.num_channels;
+    }
+
+    if (!writer.close())
+        report.error = report.output + ": write failed";
+
+    std::chrono::duration<double> const seconds = Clock::now() - begin;
+    report.seconds = seconds.count();
+}
+
+//-----------------------------------------------------------------------------
+void print_report(std::vector<Report> const& reports)
+{
+    std::printf("%-24s %10s %10s %10s", "patch", "seconds", "render_s",
+                "realtime");
+    for (auto const* name : STAGE_NAMES)
+        std::printf(" %12s", name);
+    std::printf("\n");
+
+    double total_seconds[NUM_STAGES] = {};
+    double total_samples[NUM_STAGES] = {};
+    for (auto const& r : reports)
+    {
+        if (!r.error.empty())
+        {
+            std::printf("%-24s FAILED %s\n", r.patch.c_str(), r.error.c_str());
+            continue;
+        }
+
+        std::printf("%-24s %10.2f %10.4f %9.1fx", r.patch.c_str(), r.duration,
+                    r.seconds, r.duration / r.seconds);
+        for (int s = 0; s < NUM_STAGES; ++s)
+        {
+            double const rate = r.stage_seconds[s] > 0.
+                                    ? r.stage_samples[s] / r.stage_seconds[s]
+                                    : 0.;
+            std::printf(" %12.3e", rate);
+            total_seconds[s] += r.stage_seconds[s];
+            total_samples[s] += r.stage_samples[s];
+        }
+        std::printf("\n");
+    }
+
+    std::printf("%-24s %10s %10s %10s", "total samples/s", "", "", "");
+    for (int s = 0; s < NUM_STAGES; ++s)
+    {
+        double const rate =
+            total_seconds[s] > 0. ? total_samples[s] / total_seconds[s] : 0.;
+        std::printf(" %12.3e", rate);
+    }
+    std::printf("\n");
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    mut_i32 num_jobs    = static_cast<i32>(std::thread::hardware_concurrency());
+    std::string out_dir = ".";
+    std::vector<char const*> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+            num_jobs = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            out_dir = argv[++i];
+        else if (std::strcmp(argv[i], "--isa") == 0 && i + 1 < argc)
+        {
+            core::Isa isa = core::Isa::Scalar;
+            if (!core::CpuDispatchImpl::from_string(argv[++i], isa) ||
+                !core::CpuDispatchImpl::force(isa))
+            {
+                std::fprintf(stderr, "Unsupported isa %s\n", argv[i]);
+                return 2;
+            }
+        }
+        else
+            paths.push_back(argv[i]);
+    }
+
+    if (paths.empty())
+    {
+        std::fprintf(stderr, "Usage: dsp-tool-box_render [--jobs <n>] "
+                             "[--out <dir>] [--isa <name>] <patch>...\n");
+        return 2;
+    }
+
+    // Every worker takes the next patch until none is left.
+    std::vector<Report> reports(paths.size());
+    std::atomic<size_t> next{0};
+    auto const worker = [&] {
+        for (size_t i = next++; i < paths.size(); i = next++)
+            render_patch(paths[i], out_dir, reports[i]);
+    };
+
+    num_jobs = std::clamp(num_jobs, 1, static_cast<int>(paths.size()));
+    std::vector<std::thread> threads;
+    for (mut_i32 j = 1; j < num_jobs; ++j)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    auto const isa = core::CpuDispatchImpl::active();
+    std::printf("isa %s, %d jobs\n", core::CpuDispatchImpl::to_string(isa),
+                num_jobs);
+    print_report(reports);
+
+    for (auto const& r : reports)
+    {
+        if (!r.error.empty())
+            return 1;
+    }
+
+    return 0;
+}
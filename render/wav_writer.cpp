@@ -0,0 +1,189 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "wav_writer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace ha::dtb::render {
+namespace {
+
+//-----------------------------------------------------------------------------
+constexpr u32 HEADER_BYTES      = 44;
+constexpr u32 BYTES_PER_SAMPLE  = 4;
+constexpr u32 FORMAT_IEEE_FLOAT = 3;
+
+//-----------------------------------------------------------------------------
+void put_u16(mut_u8* dst, u32 value)
+{
+    dst[0] = static_cast<mut_u8>(value & 0xFF);
+    dst[1] = static_cast<mut_u8>((value >> 8) & 0xFF);
+}
+
+//-----------------------------------------------------------------------------
+void put_u32(mut_u8* dst, u32 value)
+{
+    put_u16(dst, value & 0xFFFF);
+    put_u16(dst + 2, value >> 16);
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+WavWriter::WavWriter(i32 num_channels, real sample_rate, i32 buffer_frames)
+: num_channels(num_channels)
+, sample_rate(sample_rate)
+, buffer_frames(buffer_frames)
+{
+    auto const size = static_cast<size_t>(num_channels * buffer_frames);
+    buffers[0].assign(size, real(0.));
+    buffers[1].assign(size, real(0.));
+}
+
+//-----------------------------------------------------------------------------
+WavWriter::~WavWriter()
+{
+    close();
+}
+
+//-----------------------------------------------------------------------------
+bool WavWriter::open(char const* path)
+{
+    assert(!file);
+
+    file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+
+    // Written again with the final sizes by close().
+    active_count = 0;
+    data_bytes   = 0;
+    failed       = !write_header(0);
+    stopping     = false;
+    thread       = std::thread([this] { flush_loop(); });
+    return !failed;
+}
+
+//-----------------------------------------------------------------------------
+void WavWriter::write(core::ConstBlockView const& block)
+{
+    assert(block.num_channels == num_channels);
+
+    mut_i32 done = 0;
+    while (done < block.num_samples)
+    {
+        i32 const count = std::min(block.num_samples - done,
+                                   buffer_frames - active_count);
+        mut_real* frames =
+            buffers[active].data() + active_count * num_channels;
+        for (mut_i32 c = 0; c < num_channels; ++c)
+        {
+            auto const channel = core::BufferViewImpl::sub_range(
+                core::BufferViewImpl::channel(block, c), done, count);
+            for (mut_i32 i = 0; i < count; ++i)
+                frames[i * num_channels + c] = channel.data[i * channel.stride];
+        }
+
+        done += count;
+        active_count += count;
+        if (active_count == buffer_frames)
+            submit();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool WavWriter::close()
+{
+    if (!file)
+        return false;
+
+    submit();
+    {
+        std::lock_guard<std::mutex> const lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    thread.join();
+
+    // Longer files do not fit the 32 bit RIFF sizes.
+    u64 const max_bytes = 0xFFFFFFFFu - HEADER_BYTES;
+    bool const ok       = !failed && data_bytes <= max_bytes &&
+                    write_header(static_cast<mut_u32>(data_bytes));
+    bool const closed = std::fclose(file) == 0;
+    file              = nullptr;
+    return ok && closed;
+}
+
+//-----------------------------------------------------------------------------
+void WavWriter::submit()
+{
+    if (active_count == 0)
+        return;
+
+    // Waits only if the previous buffer is still being written.
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this] { return pending < 0; });
+    pending       = active;
+    pending_count = active_count;
+    lock.unlock();
+    condition.notify_all();
+
+    data_bytes += static_cast<mut_u64>(active_count) * num_channels *
+                  BYTES_PER_SAMPLE;
+    active       = 1 - active;
+    active_count = 0;
+}
+
+//-----------------------------------------------------------------------------
+void WavWriter::flush_loop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        condition.wait(lock, [this] { return pending >= 0 || stopping; });
+        if (pending < 0)
+            return;
+
+        i32 const index = pending;
+        auto const size = static_cast<size_t>(pending_count * num_channels);
+        lock.unlock();
+        // Samples are stored as they are in memory, which matches WAV on
+        // little endian hosts.
+        bool const ok =
+            std::fwrite(buffers[index].data(), sizeof(float), size, file) ==
+            size;
+        lock.lock();
+        failed |= !ok;
+        pending = -1;
+        condition.notify_all();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool WavWriter::write_header(u32 num_data_bytes)
+{
+    u32 const channels    = static_cast<mut_u32>(num_channels);
+    u32 const rate        = static_cast<mut_u32>(sample_rate);
+    u32 const block_align = channels * BYTES_PER_SAMPLE;
+
+    mut_u8 header[HEADER_BYTES] = {};
+    std::memcpy(header, "RIFF", 4);
+    put_u32(header + 4, HEADER_BYTES - 8 + num_data_bytes);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    put_u32(header + 16, 16);
+    put_u16(header + 20, FORMAT_IEEE_FLOAT);
+    put_u16(header + 22, channels);
+    put_u32(header + 24, rate);
+    put_u32(header + 28, rate * block_align);
+    put_u16(header + 32, block_align);
+    put_u16(header + 34, BYTES_PER_SAMPLE * 8);
+    std::memcpy(header + 36, "data", 4);
+    put_u32(header + 40, num_data_bytes);
+
+    return std::fseek(file, 0, SEEK_SET) == 0 &&
+           std::fwrite(header, 1, HEADER_BYTES, file) == HEADER_BYTES;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::render
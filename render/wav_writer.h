@@ -0,0 +1,78 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+#include "ha/dsp_tool_box/core/buffer_view.h"
+#include "ha/dsp_tool_box/core/types.h"
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ha::dtb::render {
+
+/**
+ * @brief Streams 32 bit float WAV files. Blocks are interleaved into one of
+ * two preallocated buffers. A full buffer is written by a background thread
+ * while the caller fills the other one, so write() neither allocates nor
+ * waits for the disk unless the disk falls a whole buffer behind.
+ */
+class WavWriter final
+{
+public:
+    //-------------------------------------------------------------------------
+    /**
+     * @param buffer_frames Frames per buffer
+     */
+    WavWriter(i32 num_channels, real sample_rate, i32 buffer_frames = 16384);
+    ~WavWriter();
+
+    WavWriter(WavWriter const&) = delete;
+    WavWriter& operator=(WavWriter const&) = delete;
+
+    /**
+     * @brief Creates the file and starts the background thread
+     */
+    bool open(char const* path);
+
+    /**
+     * @brief Appends a block, one channel per output channel
+     */
+    void write(core::ConstBlockView const& block);
+
+    /**
+     * @brief Writes the remaining frames and the final header
+     *
+     * @return Returns false if any write failed
+     */
+    bool close();
+
+    //-------------------------------------------------------------------------
+private:
+    void submit();
+    void flush_loop();
+    bool write_header(u32 num_data_bytes);
+
+    i32 num_channels;
+    real sample_rate;
+    i32 buffer_frames;
+
+    std::FILE* file = nullptr;
+    std::vector<mut_real> buffers[2];
+    mut_i32 active       = 0;
+    mut_i32 active_count = 0;
+    mut_u64 data_bytes   = 0;
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    //! Buffer handed to the background thread, -1 if none
+    mut_i32 pending       = -1;
+    mut_i32 pending_count = 0;
+    bool stopping         = false;
+    bool failed           = false;
+};
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::render
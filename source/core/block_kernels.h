@@ -0,0 +1,173 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#pragma once
+
+/**
+ * Kernel bodies shared by all instruction sets. Each block_kernels_<isa>.cpp
+ * defines HA_DTB_KERNEL_NAMESPACE and includes this file once, its compile
+ * flags decide which instructions the compiler vectorises the loops with.
+ *
+ * Everything in here has internal linkage on purpose. An inline function
+ * compiled with e.g. AVX2 must never be merged with its scalar twin by the
+ * linker. For the same reason no standard library templates are used.
+ */
+
+#include "ha/dsp_tool_box/core/cpu_dispatch.h"
+#include <cstring>
+
+#ifndef HA_DTB_KERNEL_NAMESPACE
+#error "Define HA_DTB_KERNEL_NAMESPACE before including block_kernels.h"
+#endif
+
+#ifndef HA_DTB_KERNEL_EXACT_EASING
+#define HA_DTB_KERNEL_EXACT_EASING 0
+#endif
+
+#if HA_DTB_KERNEL_EXACT_EASING
+#include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#endif
+
+namespace ha::dtb::core::HA_DTB_KERNEL_NAMESPACE {
+namespace {
+
+//-----------------------------------------------------------------------------
+#if HA_DTB_KERNEL_EXACT_EASING
+real ease(real x)
+{
+    return modulation::easing::ease_virus_ti<real>(x);
+}
+#else
+//! 96dB / 20 * log2(10), \sa modulation::easing::ease_virus_ti
+constexpr real EASE_MULTIPLICATOR = real(96. / 20. * 3.32192809488736234787);
+constexpr real MIN_EXPONENT       = real(-126.);
+
+//-----------------------------------------------------------------------------
+/**
+ * 2^y for y in [-126, 0]. Rounds y to an integer by adding 1.5 * 2^23, which
+ * leaves the integer in the low mantissa bits. Approximates 2^fraction for the
+ * remaining fraction in [-0.5, 0.5] with a polynomial (Cephes exp2f) and
+ * scales by 2^integer via the float exponent bits. No float to int
+ * conversion, so the compiler can vectorise the callers.
+ */
+real fast_exp2(real y)
+{
+    constexpr real ROUNDING_SHIFT      = real(12582912.);
+    constexpr std::int32_t SHIFT_BITS = 0x4B400000;
+
+    real const clamped  = y < MIN_EXPONENT ? MIN_EXPONENT : y;
+    real const shifted  = clamped + ROUNDING_SHIFT;
+    real const rounded  = shifted - ROUNDING_SHIFT;
+    real const fraction = clamped - rounded;
+
+    mut_real poly = real(1.535336188319500e-4);
+    poly          = poly * fraction + real(1.339887440266574e-3);
+    poly          = poly * fraction + real(9.618437357674640e-3);
+    poly          = poly * fraction + real(5.550332471162809e-2);
+    poly          = poly * fraction + real(2.402264791363012e-1);
+    poly          = poly * fraction + real(6.931472028550421e-1);
+    poly          = poly * fraction + real(1.);
+
+    std::int32_t shifted_bits = 0;
+    std::memcpy(&shifted_bits, &shifted, sizeof(shifted_bits));
+    std::int32_t const bits = (shifted_bits - SHIFT_BITS + 127) << 23;
+    mut_real scale          = real(0.);
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return poly * scale;
+}
+
+//-----------------------------------------------------------------------------
+real ease(real x)
+{
+    return real(1.) - fast_exp2(-x * EASE_MULTIPLICATOR);
+}
+#endif
+
+//-----------------------------------------------------------------------------
+void one_pole_step(real const* a,
+                   real const* b,
+                   mut_real* z,
+                   real const* in,
+                   mut_real* out,
+                   i32 num)
+{
+    for (mut_i32 i = 0; i < num; ++i)
+    {
+        real const filtered = (in[i] * b[i]) + (z[i] * a[i]);
+        z[i]                = in[i] == z[i] ? z[i] : filtered;
+        out[i]              = z[i];
+    }
+}
+
+//-----------------------------------------------------------------------------
+void advance_phases(mut_real* values,
+                    real const* increments,
+                    mut_u8* overflows,
+                    i32 num_samples,
+                    i32 num)
+{
+    real const factor = static_cast<real>(num_samples);
+    for (mut_i32 i = 0; i < num; ++i)
+    {
+        // Subtracting the integer part unconditionally keeps values in [0, 1)
+        // untouched and avoids a branch.
+        real const value   = values[i] + increments[i] * factor;
+        real const integer = static_cast<real>(static_cast<i32>(value));
+        values[i]          = value - integer;
+        overflows[i]       = static_cast<mut_u8>(value >= real(1.));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void ease_virus_ti(real const* in, mut_real* out, i32 num)
+{
+    for (mut_i32 i = 0; i < num; ++i)
+        out[i] = ease(in[i]);
+}
+
+//-----------------------------------------------------------------------------
+void evaluate_segments(real const* x,
+                       real const* from,
+                       real const* to,
+                       u8 const* eased,
+                       mut_real* out,
+                       i32 num)
+{
+    for (mut_i32 i = 0; i < num; ++i)
+    {
+        real const shaped = ease(x[i]);
+        real const curve  = eased[i] != 0 ? shaped : x[i];
+        out[i]           = from[i] + (to[i] - from[i]) * curve;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void fir(real const* in, real const* taps, mut_real* out, i32 num_taps, i32 num)
+{
+    // Taps in the outer loop, the inner loop runs over independent outputs.
+    for (mut_i32 i = 0; i < num; ++i)
+        out[i] = taps[0] * in[i];
+
+    for (mut_i32 k = 1; k < num_taps; ++k)
+    {
+        real const tap     = taps[k];
+        real const* window = in + k;
+        for (mut_i32 i = 0; i < num; ++i)
+            out[i] += tap * window[i];
+    }
+}
+
+//-----------------------------------------------------------------------------
+BlockKernels const KERNELS = {&one_pole_step, &advance_phases, &ease_virus_ti,
+                              &evaluate_segments, &fir};
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+BlockKernels const& block_kernels()
+{
+    return KERNELS;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::core::HA_DTB_KERNEL_NAMESPACE
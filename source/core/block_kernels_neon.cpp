@@ -0,0 +1,4 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#define HA_DTB_KERNEL_NAMESPACE neon
+#include "block_kernels.h"
@@ -0,0 +1,5 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#define HA_DTB_KERNEL_NAMESPACE scalar
+#define HA_DTB_KERNEL_EXACT_EASING 1
+#include "block_kernels.h"
@@ -0,0 +1,4 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#define HA_DTB_KERNEL_NAMESPACE sse2
+#include "block_kernels.h"
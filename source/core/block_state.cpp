@@ -0,0 +1,145 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/core/block_state.h"
+#include <cassert>
+
+namespace ha::dtb::core {
+namespace {
+
+//-----------------------------------------------------------------------------
+void scale(ConstChannelView const& in, real factor, MutChannelView const& out)
+{
+    for (mut_i32 i = 0; i < out.num_samples; ++i)
+        out.data[i * out.stride] = in.data[i * in.stride] * factor;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+BlockState BlockStateImpl::dynamic()
+{
+    return {BlockState::Kind::Dynamic, real(0.)};
+}
+
+//-----------------------------------------------------------------------------
+BlockState BlockStateImpl::constant(real value)
+{
+    if (value == real(0.))
+        return silent();
+
+    return {BlockState::Kind::Constant, value};
+}
+
+//-----------------------------------------------------------------------------
+BlockState BlockStateImpl::silent()
+{
+    return {BlockState::Kind::Silent, real(0.)};
+}
+
+//-----------------------------------------------------------------------------
+bool BlockStateImpl::is_constant(BlockState const& state)
+{
+    return state.kind != BlockState::Kind::Dynamic;
+}
+
+//-----------------------------------------------------------------------------
+bool BlockStateImpl::is_silent(BlockState const& state)
+{
+    return state.kind == BlockState::Kind::Silent;
+}
+
+//-----------------------------------------------------------------------------
+BlockState BlockStateImpl::detect(ConstChannelView const& in)
+{
+    if (in.num_samples == 0)
+        return silent();
+
+    real const first = in.data[0];
+    for (mut_i32 i = 1; i < in.num_samples; ++i)
+    {
+        if (in.data[i * in.stride] != first)
+            return dynamic();
+    }
+    return constant(first);
+}
+
+//-----------------------------------------------------------------------------
+BlockState BlockStateImpl::multiply(ConstChannelView const& in,
+                                    BlockState const& in_state,
+                                    ConstChannelView const& gain,
+                                    BlockState const& gain_state,
+                                    MutChannelView const& out)
+{
+    assert(in.num_samples == out.num_samples);
+    assert(gain.num_samples == out.num_samples);
+
+    if (is_silent(in_state) || is_silent(gain_state))
+    {
+        BufferViewImpl::fill(out, real(0.));
+        return silent();
+    }
+
+    bool const in_constant   = is_constant(in_state);
+    bool const gain_constant = is_constant(gain_state);
+    if (in_constant && gain_constant)
+    {
+        BlockState const state = constant(in_state.value * gain_state.value);
+        BufferViewImpl::fill(out, state.value);
+        return state;
+    }
+
+    if (gain_constant)
+    {
+        scale(in, gain_state.value, out);
+        return dynamic();
+    }
+
+    if (in_constant)
+    {
+        scale(gain, in_state.value, out);
+        return dynamic();
+    }
+
+    for (mut_i32 i = 0; i < out.num_samples; ++i)
+    {
+        out.data[i * out.stride] =
+            in.data[i * in.stride] * gain.data[i * gain.stride];
+    }
+    return dynamic();
+}
+
+//-----------------------------------------------------------------------------
+void BlockStateImpl::accumulate(MutChannelView const& sum,
+                                BlockState& sum_state,
+                                ConstChannelView const& mod,
+                                BlockState const& mod_state,
+                                real depth)
+{
+    assert(sum.num_samples == mod.num_samples);
+
+    if (is_silent(mod_state) || depth == real(0.))
+        return;
+
+    if (is_constant(mod_state))
+    {
+        real const offset = depth * mod_state.value;
+        if (is_constant(sum_state))
+        {
+            sum_state = constant(sum_state.value + offset);
+            BufferViewImpl::fill(sum, sum_state.value);
+            return;
+        }
+
+        for (mut_i32 i = 0; i < sum.num_samples; ++i)
+            sum.data[i * sum.stride] += offset;
+        return;
+    }
+
+    for (mut_i32 i = 0; i < sum.num_samples; ++i)
+        sum.data[i * sum.stride] += depth * mod.data[i * mod.stride];
+    sum_state = dynamic();
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::core
@@ -0,0 +1,276 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/core/cpu_dispatch.h"
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER) && HA_DTB_HAS_X86_KERNELS
+#include <intrin.h>
+#endif
+
+namespace ha::dtb::core {
+
+//-----------------------------------------------------------------------------
+namespace scalar {
+BlockKernels const& block_kernels();
+}
+#if HA_DTB_HAS_X86_KERNELS
+namespace sse2 {
+BlockKernels const& block_kernels();
+}
+namespace avx2 {
+BlockKernels const& block_kernels();
+}
+namespace avx512 {
+BlockKernels const& block_kernels();
+}
+#endif
+#if HA_DTB_HAS_NEON_KERNELS
+namespace neon {
+BlockKernels const& block_kernels();
+}
+#endif
+
+namespace {
+
+//-----------------------------------------------------------------------------
+constexpr char const* ISA_NAMES[] = {"scalar", "sse2", "avx2", "avx512",
+                                     "neon"};
+static_assert(sizeof(ISA_NAMES) / sizeof(ISA_NAMES[0]) ==
+                  static_cast<size_t>(Isa::Count),
+              "Name every Isa");
+
+//-----------------------------------------------------------------------------
+#if HA_DTB_HAS_X86_KERNELS
+#if defined(_MSC_VER)
+bool os_saves_registers(std::uint64_t mask)
+{
+    int info[4] = {};
+    __cpuid(info, 1);
+    bool const has_osxsave = (info[2] & (1 << 27)) != 0;
+    return has_osxsave && (_xgetbv(0) & mask) == mask;
+}
+
+//-----------------------------------------------------------------------------
+bool cpu_supports(Isa isa)
+{
+    int info[4] = {};
+    __cpuid(info, 0);
+    int const max_leaf = info[0];
+
+    __cpuid(info, 1);
+    bool const sse2 = (info[3] & (1 << 26)) != 0;
+
+    bool avx2 = false, avx512f = false;
+    if (max_leaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        avx2    = (info[1] & (1 << 5)) != 0;
+        avx512f = (info[1] & (1 << 16)) != 0;
+    }
+
+    switch (isa)
+    {
+        case Isa::SSE2:
+            return sse2;
+        case Isa::AVX2:
+            return avx2 && os_saves_registers(0x6);
+        case Isa::AVX512:
+            return avx512f && os_saves_registers(0xe6);
+        default:
+            return false;
+    }
+}
+#else
+bool cpu_supports(Isa isa)
+{
+    __builtin_cpu_init();
+    switch (isa)
+    {
+        case Isa::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case Isa::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case Isa::AVX512:
+            return __builtin_cpu_supports("avx512f");
+        default:
+            return false;
+    }
+}
+#endif
+#endif
+
+//-----------------------------------------------------------------------------
+/**
+ * CMake option DTB_FORCE_ISA first, environment variable HA_DTB_FORCE_ISA
+ * second, best supported otherwise. An unknown or unsupported forced ISA
+ * falls back to the best supported one with a warning on stderr.
+ */
+Isa initial_isa()
+{
+    char const* name = std::getenv("HA_DTB_FORCE_ISA");
+#if defined(HA_DTB_FORCE_ISA)
+    name = HA_DTB_FORCE_ISA;
+#endif
+
+    Isa const best = CpuDispatchImpl::best_supported();
+    if (!name || name[0] == '\0')
+        return best;
+
+    Isa forced = Isa::Scalar;
+    if (!CpuDispatchImpl::from_string(name, forced))
+    {
+        std::fprintf(stderr,
+                     "dsp-tool-box: unknown forced ISA '%s', using %s\n",
+                     name, CpuDispatchImpl::to_string(best));
+        return best;
+    }
+
+    if (!CpuDispatchImpl::is_supported(forced))
+    {
+        std::fprintf(stderr,
+                     "dsp-tool-box: forced ISA %s is not supported, using %s\n",
+                     name, CpuDispatchImpl::to_string(best));
+        return best;
+    }
+
+    return forced;
+}
+
+//-----------------------------------------------------------------------------
+struct ActiveKernels
+{
+    std::atomic<Isa> isa;
+    std::atomic<BlockKernels const*> kernels;
+};
+
+ActiveKernels& active_kernels()
+{
+    static ActiveKernels active = [] {
+        Isa const isa = initial_isa();
+        return ActiveKernels{{isa}, {&CpuDispatchImpl::kernels(isa)}};
+    }();
+    return active;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool CpuDispatchImpl::is_supported(Isa isa)
+{
+    switch (isa)
+    {
+        case Isa::Scalar:
+            return true;
+#if HA_DTB_HAS_X86_KERNELS
+        case Isa::SSE2:
+        case Isa::AVX2:
+        case Isa::AVX512: {
+            static bool const supported[] = {cpu_supports(Isa::SSE2),
+                                             cpu_supports(Isa::AVX2),
+                                             cpu_supports(Isa::AVX512)};
+            return supported[static_cast<int>(isa) -
+                             static_cast<int>(Isa::SSE2)];
+        }
+#endif
+#if HA_DTB_HAS_NEON_KERNELS
+        case Isa::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+//-----------------------------------------------------------------------------
+Isa CpuDispatchImpl::best_supported()
+{
+    constexpr Isa PREFERENCE[] = {Isa::AVX512, Isa::AVX2, Isa::NEON,
+                                  Isa::SSE2};
+    for (Isa isa : PREFERENCE)
+    {
+        if (is_supported(isa))
+            return isa;
+    }
+
+    return Isa::Scalar;
+}
+
+//-----------------------------------------------------------------------------
+Isa CpuDispatchImpl::active()
+{
+    return active_kernels().isa.load(std::memory_order_acquire);
+}
+
+//-----------------------------------------------------------------------------
+bool CpuDispatchImpl::force(Isa isa)
+{
+    if (!is_supported(isa))
+        return false;
+
+    auto& active = active_kernels();
+    active.kernels.store(&kernels(isa), std::memory_order_release);
+    active.isa.store(isa, std::memory_order_release);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+BlockKernels const& CpuDispatchImpl::kernels()
+{
+    return *active_kernels().kernels.load(std::memory_order_acquire);
+}
+
+//-----------------------------------------------------------------------------
+BlockKernels const& CpuDispatchImpl::kernels(Isa isa)
+{
+    assert(is_supported(isa));
+    switch (isa)
+    {
+#if HA_DTB_HAS_X86_KERNELS
+        case Isa::SSE2:
+            return sse2::block_kernels();
+        case Isa::AVX2:
+            return avx2::block_kernels();
+        case Isa::AVX512:
+            return avx512::block_kernels();
+#endif
+#if HA_DTB_HAS_NEON_KERNELS
+        case Isa::NEON:
+            return neon::block_kernels();
+#endif
+        case Isa::Scalar:
+        default:
+            return scalar::block_kernels();
+    }
+}
+
+//-----------------------------------------------------------------------------
+char const* CpuDispatchImpl::to_string(Isa isa)
+{
+    if (isa >= Isa::Count)
+        return "unknown";
+
+    return ISA_NAMES[static_cast<size_t>(isa)];
+}
+
+//-----------------------------------------------------------------------------
+bool CpuDispatchImpl::from_string(char const* name, Isa& isa)
+{
+    for (size_t i = 0; i < static_cast<size_t>(Isa::Count); ++i)
+    {
+        if (std::strcmp(name, ISA_NAMES[i]) == 0)
+        {
+            isa = static_cast<Isa>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::core
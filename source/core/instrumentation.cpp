@@ -0,0 +1,71 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/core/instrumentation.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define HA_DTB_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HA_DTB_HAS_RDTSC 1
+#else
+#include <chrono>
+#endif
+
+namespace ha::dtb::core {
+namespace {
+
+//-----------------------------------------------------------------------------
+thread_local BlockReport* active_block_report = nullptr;
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+void InstrumentationImpl::begin_block(Profiler& self)
+{
+    self.current             = BlockReport{};
+    self.current.block_index = self.block_counter++;
+    active_block_report      = &self.current;
+}
+
+//-----------------------------------------------------------------------------
+void InstrumentationImpl::end_block(Profiler& self)
+{
+    if (active_block_report == &self.current)
+        active_block_report = nullptr;
+
+    if (!self.reports.try_push(self.current))
+        self.dropped_reports.fetch_add(1, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+bool InstrumentationImpl::try_pop(Profiler& self, BlockReport& report)
+{
+    return self.reports.try_pop(report);
+}
+
+//-----------------------------------------------------------------------------
+BlockReport* InstrumentationImpl::active_report()
+{
+    return active_block_report;
+}
+
+//-----------------------------------------------------------------------------
+u64 InstrumentationImpl::read_cycle_counter()
+{
+#if defined(HA_DTB_HAS_RDTSC)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    mut_u64 value = 0;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    using namespace std::chrono;
+    auto const now = steady_clock::now().time_since_epoch();
+    return static_cast<u64>(duration_cast<nanoseconds>(now).count());
+#endif
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::core
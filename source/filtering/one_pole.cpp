@@ -1,12 +1,26 @@
 // Copyright(c) 2021 Hansen Audio.
 
 #include "ha/dsp_tool_box/filtering/one_pole.h"
+#include "ha/dsp_tool_box/core/coefficient_cache.h"
+#include "ha/dsp_tool_box/core/instrumentation.h"
 
+#include <array>
+#include <cassert>
 #include <math.h>
 
 namespace ha::dtb::filtering {
 namespace {
 
+//-----------------------------------------------------------------------------
+using OnePoleKey   = std::array<mut_real, 2>;
+using OnePoleCache = core::CoefficientCache<OnePoleKey, OnePoleCoefficients>;
+
+OnePoleCache& one_pole_cache()
+{
+    static OnePoleCache cache;
+    return cache;
+}
+
 //-----------------------------------------------------------------------------
 bool is_equal(const OnePole& self, real in)
 {
@@ -33,13 +47,89 @@ void OnePoleImpl::update_pole(OnePole& self, real a)
 //-----------------------------------------------------------------------------
 real OnePoleImpl::process(OnePole& self, real in)
 {
+    HA_DTB_PROFILE_SCOPE(core::Probe::OnePole);
+
     if (is_equal(self, in))
+    {
+        HA_DTB_PROFILE_COUNT(one_pole_settled);
         return self.z;
+    }
 
+    HA_DTB_PROFILE_COUNT(one_pole_active);
     self.z = (in * self.b) + (self.z * self.a);
     return self.z;
 }
 
+//-----------------------------------------------------------------------------
+core::BlockState OnePoleImpl::process(OnePole& self,
+                                      core::ConstChannelView const& in,
+                                      core::MutChannelView const& out)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::OnePole);
+
+    assert(in.num_samples == out.num_samples);
+    real const start = self.z;
+    mut_real z       = start;
+    bool settled     = true;
+    for (mut_i32 i = 0; i < out.num_samples; ++i)
+    {
+        real const sample   = in.data[i * in.stride];
+        real const filtered = (sample * self.b) + (z * self.a);
+        z                   = sample == z ? z : filtered;
+        settled             = settled && z == start;
+        out.data[i * out.stride] = z;
+    }
+    self.z = z;
+
+    if (settled)
+    {
+        HA_DTB_PROFILE_COUNT(one_pole_settled);
+        return core::BlockStateImpl::constant(start);
+    }
+
+    HA_DTB_PROFILE_COUNT(one_pole_active);
+    return core::BlockStateImpl::dynamic();
+}
+
+//-----------------------------------------------------------------------------
+core::BlockState OnePoleImpl::process(OnePole& self,
+                                      core::ConstChannelView const& in,
+                                      core::BlockState const& in_state,
+                                      core::MutChannelView const& out)
+{
+    if (!core::BlockStateImpl::is_constant(in_state))
+        return process(self, in, out);
+
+    HA_DTB_PROFILE_SCOPE(core::Probe::OnePole);
+
+    if (is_equal(self, in_state.value))
+    {
+        HA_DTB_PROFILE_COUNT(one_pole_settled);
+        core::BufferViewImpl::fill(out, self.z);
+        return core::BlockStateImpl::constant(self.z);
+    }
+
+    HA_DTB_PROFILE_COUNT(one_pole_active);
+
+    real const sample = in_state.value;
+    mut_real z        = self.z;
+    for (mut_i32 i = 0; i < out.num_samples; ++i)
+    {
+        real const filtered = (sample * self.b) + (z * self.a);
+        z                   = sample == z ? z : filtered;
+        out.data[i * out.stride] = z;
+    }
+    self.z = z;
+    return core::BlockStateImpl::dynamic();
+}
+
+//-----------------------------------------------------------------------------
+core::BlockState OnePoleImpl::process(OnePole& self,
+                                      core::MutChannelView const& in_out)
+{
+    return process(self, core::BufferViewImpl::as_const(in_out), in_out);
+}
+
 //-----------------------------------------------------------------------------
 void OnePoleImpl::reset(OnePole& self, real in)
 {
@@ -55,5 +145,39 @@ real OnePoleImpl::tau_to_pole(real tau, real sample_rate)
     return real(exp(real(-1) / ((tau * RECIPROCAL_5) * sample_rate)));
 }
 
+//-----------------------------------------------------------------------------
+std::shared_ptr<OnePoleCoefficients const>
+OnePoleImpl::intern(real tau, real sample_rate)
+{
+    return one_pole_cache().intern({tau, sample_rate}, [](OnePoleKey key) {
+        real const a = tau_to_pole(key[0], key[1]);
+        return OnePoleCoefficients{a, real(1.) - a};
+    });
+}
+
+//-----------------------------------------------------------------------------
+std::size_t OnePoleImpl::collect_interned()
+{
+    return one_pole_cache().collect();
+}
+
+//-----------------------------------------------------------------------------
+real OnePoleImpl::process(OnePoleCoefficients const& coeffs,
+                          mut_real& z,
+                          real in)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::OnePole);
+
+    if (in == z)
+    {
+        HA_DTB_PROFILE_COUNT(one_pole_settled);
+        return z;
+    }
+
+    HA_DTB_PROFILE_COUNT(one_pole_active);
+    z = (in * coeffs.b) + (z * coeffs.a);
+    return z;
+}
+
 //-----------------------------------------------------------------------------
 } // namespace ha::dtb::filtering
\ No newline at end of file
@@ -0,0 +1,144 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/filtering/one_pole_bank.h"
+#include "ha/dsp_tool_box/core/cpu_dispatch.h"
+#include "ha/dsp_tool_box/core/instrumentation.h"
+#include <cassert>
+
+namespace ha::dtb::filtering {
+
+//-----------------------------------------------------------------------------
+OnePoleBank OnePoleBankImpl::create(i32 num_filters, real a)
+{
+    auto const num = static_cast<size_t>(num_filters);
+    OnePoleBank self;
+    self.a.assign(num, a);
+    self.b.assign(num, real(1.) - a);
+    self.z.assign(num, real(0.));
+    return self;
+}
+
+//-----------------------------------------------------------------------------
+void OnePoleBankImpl::update_pole(OnePoleBank& self, i32 index, real a)
+{
+    self.a[index] = a;
+    self.b[index] = real(1.) - a;
+}
+
+//-----------------------------------------------------------------------------
+void OnePoleBankImpl::reset(OnePoleBank& self, i32 index, real in)
+{
+    self.z[index] = in;
+}
+
+//-----------------------------------------------------------------------------
+void OnePoleBankImpl::process(OnePoleBank& self, real const* in, mut_real* out)
+{
+    process(self, in, out, 1);
+}
+
+//-----------------------------------------------------------------------------
+void OnePoleBankImpl::process(OnePoleBank& self,
+                              real const* in,
+                              mut_real* out,
+                              i32 num_samples)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::OnePoleBank);
+
+    auto const& kernels = core::CpuDispatchImpl::kernels();
+    i32 const num       = size(self);
+
+#if HA_DTB_ENABLE_INSTRUMENTATION
+    // A filter is settled if its input equals its state for the whole block.
+    for (mut_i32 f = 0; f < num; ++f)
+    {
+        bool settled = true;
+        for (mut_i32 i = 0; i < num_samples && settled; ++i)
+            settled = in[i * num + f] == self.z[f];
+
+        if (settled)
+            HA_DTB_PROFILE_COUNT(one_pole_settled);
+        else
+            HA_DTB_PROFILE_COUNT(one_pole_active);
+    }
+#endif
+
+    for (mut_i32 i = 0; i < num_samples; ++i)
+    {
+        kernels.one_pole_step(self.a.data(), self.b.data(), self.z.data(),
+                              in + i * num, out + i * num, num);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void OnePoleBankImpl::process(OnePoleBank& self,
+                              core::ConstBlockView const& in,
+                              core::MutBlockView const& out)
+{
+    using core::BufferViewImpl;
+
+    assert(in.num_channels == size(self) && out.num_channels == size(self));
+    assert(in.num_samples == out.num_samples);
+    if (BufferViewImpl::is_interleaved(in) &&
+        BufferViewImpl::is_interleaved(out))
+    {
+        return process(self, BufferViewImpl::frames(in),
+                       BufferViewImpl::frames(out), out.num_samples);
+    }
+
+    for (mut_i32 i = 0; i < out.num_channels; ++i)
+    {
+        process_filter(self, i, BufferViewImpl::channel(in, i),
+                       BufferViewImpl::channel(out, i));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void OnePoleBankImpl::process_filter(OnePoleBank& self,
+                                     i32 index,
+                                     real const* in,
+                                     mut_real* out,
+                                     i32 num_samples)
+{
+    process_filter(self, index, core::BufferViewImpl::channel(in, num_samples),
+                   core::BufferViewImpl::channel(out, num_samples));
+}
+
+//-----------------------------------------------------------------------------
+void OnePoleBankImpl::process_filter(OnePoleBank& self,
+                                     i32 index,
+                                     core::ConstChannelView const& in,
+                                     core::MutChannelView const& out)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::OnePoleBank);
+
+    assert(in.num_samples == out.num_samples);
+    real const a     = self.a[index];
+    real const b     = self.b[index];
+    real const start = self.z[index];
+    mut_real z       = start;
+    bool settled     = true;
+    for (mut_i32 i = 0; i < out.num_samples; ++i)
+    {
+        real const sample   = in.data[i * in.stride];
+        real const filtered = (sample * b) + (z * a);
+        z                   = sample == z ? z : filtered;
+        settled             = settled && z == start;
+        out.data[i * out.stride] = z;
+    }
+    self.z[index] = z;
+
+    if (settled)
+        HA_DTB_PROFILE_COUNT(one_pole_settled);
+    else
+        HA_DTB_PROFILE_COUNT(one_pole_active);
+}
+
+//-----------------------------------------------------------------------------
+i32 OnePoleBankImpl::size(OnePoleBank const& self)
+{
+    return static_cast<i32>(self.z.size());
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::filtering
@@ -0,0 +1,397 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/filtering/oversampler.h"
+#include "ha/dsp_tool_box/core/cpu_dispatch.h"
+#include "ha/dsp_tool_box/core/instrumentation.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstring>
+
+namespace ha::dtb::filtering {
+namespace {
+
+//-----------------------------------------------------------------------------
+using Stage   = Oversampler::Stage;
+using Complex = std::complex<double>;
+
+constexpr double PI = 3.14159265358979323846;
+
+//! Halfband prototypes have 4 * K - 1 taps. The first stage needs the
+//! steepest transition, the later ones only reject the images above it.
+constexpr i32 FIRST_STAGE_K = 12;
+constexpr i32 LATER_STAGE_K = 5;
+//! About 80dB stopband attenuation
+constexpr double KAISER_BETA   = 8.;
+constexpr i32 CEPSTRUM_SIZE    = 1024;
+constexpr double MIN_MAGNITUDE = 1e-9;
+
+//-----------------------------------------------------------------------------
+double bessel_i0(double x)
+{
+    double sum  = 1.;
+    double term = 1.;
+    for (int k = 1; k < 50; ++k)
+    {
+        double const factor = x / (2. * k);
+        term *= factor * factor;
+        sum += term;
+    }
+    return sum;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Kaiser windowed sinc with its cutoff at a quarter of the sample rate. Every
+ * second tap besides the center is 0.
+ */
+std::vector<double> design_halfband(i32 k)
+{
+    i32 const num_taps = 4 * k - 1;
+    i32 const center   = 2 * k - 1;
+
+    std::vector<double> taps(static_cast<size_t>(num_taps), 0.);
+    double even_sum = 0.;
+    for (mut_i32 n = 0; n < num_taps; n += 2)
+    {
+        double const x      = 0.5 * static_cast<double>(n - center);
+        double const ratio  = static_cast<double>(n - center) / center;
+        double const window = bessel_i0(KAISER_BETA *
+                                        std::sqrt(1. - ratio * ratio)) /
+                              bessel_i0(KAISER_BETA);
+        taps[n] = 0.5 * std::sin(PI * x) / (PI * x) * window;
+        even_sum += taps[n];
+    }
+
+    // Unity gain at DC for both polyphase branches.
+    for (mut_i32 n = 0; n < num_taps; n += 2)
+        taps[n] *= 0.5 / even_sum;
+    taps[center] = 0.5;
+    return taps;
+}
+
+//-----------------------------------------------------------------------------
+void fft(std::vector<Complex>& data, bool inverse)
+{
+    size_t const size = data.size();
+    for (size_t i = 1, j = 0; i < size; ++i)
+    {
+        size_t bit = size >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(data[i], data[j]);
+    }
+
+    double const sign = inverse ? 1. : -1.;
+    for (size_t length = 2; length <= size; length <<= 1)
+    {
+        double const angle = sign * 2. * PI / static_cast<double>(length);
+        Complex const step(std::cos(angle), std::sin(angle));
+        for (size_t i = 0; i < size; i += length)
+        {
+            Complex twiddle(1.);
+            for (size_t j = 0; j < length / 2; ++j)
+            {
+                Complex const odd        = data[i + j + length / 2] * twiddle;
+                data[i + j + length / 2] = data[i + j] - odd;
+                data[i + j] += odd;
+                twiddle *= step;
+            }
+        }
+    }
+
+    if (inverse)
+    {
+        for (auto& value : data)
+            value /= static_cast<double>(size);
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Homomorphic (cepstral) method: keeps the magnitude response and moves all
+ * zeros inside the unit circle.
+ */
+std::vector<double> to_minimum_phase(std::vector<double> const& taps)
+{
+    std::vector<Complex> spectrum(CEPSTRUM_SIZE, Complex(0.));
+    std::copy(taps.begin(), taps.end(), spectrum.begin());
+    fft(spectrum, false);
+    for (auto& bin : spectrum)
+        bin = std::log(std::max(std::abs(bin), MIN_MAGNITUDE));
+
+    fft(spectrum, true);
+    auto& cepstrum = spectrum;
+    for (size_t n = 1; n < CEPSTRUM_SIZE / 2; ++n)
+        cepstrum[n] *= 2.;
+    for (size_t n = CEPSTRUM_SIZE / 2 + 1; n < CEPSTRUM_SIZE; ++n)
+        cepstrum[n] = 0.;
+
+    fft(cepstrum, false);
+    for (auto& bin : cepstrum)
+        bin = std::exp(bin);
+    fft(cepstrum, true);
+
+    std::vector<double> result(taps.size());
+    double sum = 0.;
+    for (size_t n = 0; n < result.size(); ++n)
+    {
+        result[n] = cepstrum[n].real();
+        sum += result[n];
+    }
+    for (auto& tap : result)
+        tap /= sum;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+double group_delay_at_dc(std::vector<double> const& taps)
+{
+    double weighted = 0., sum = 0.;
+    for (size_t n = 0; n < taps.size(); ++n)
+    {
+        weighted += static_cast<double>(n) * taps[n];
+        sum += taps[n];
+    }
+    return weighted / sum;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Splits the prototype into its even and odd branch, scaled by 2 for the
+ * zero stuffing of the upsampler.
+ */
+Stage create_stage(std::vector<double> const& prototype,
+                   bool halfband,
+                   i32 max_block_size)
+{
+    i32 const num_taps = static_cast<i32>(prototype.size() + 1) / 2;
+    auto const taps    = static_cast<size_t>(num_taps);
+    auto const block   = static_cast<size_t>(max_block_size);
+
+    Stage stage;
+    stage.num_taps = num_taps;
+    stage.halfband = halfband;
+    stage.even_taps.assign(taps, real(0.));
+    stage.odd_taps.assign(taps, real(0.));
+    for (mut_i32 k = 0; k < num_taps; ++k)
+    {
+        size_t const reversed = static_cast<size_t>(num_taps - 1 - k);
+        size_t const even     = static_cast<size_t>(2 * k);
+        stage.even_taps[reversed] = static_cast<real>(2. * prototype[even]);
+        if (even + 1 < prototype.size())
+            stage.odd_taps[reversed] =
+                static_cast<real>(2. * prototype[even + 1]);
+    }
+
+    stage.up_history.assign(taps - 1 + block, real(0.));
+    stage.down_even_history.assign(taps - 1 + block, real(0.));
+    stage.down_odd_history.assign(taps + block, real(0.));
+    stage.even_out.assign(block, real(0.));
+    stage.odd_out.assign(block, real(0.));
+    return stage;
+}
+
+//-----------------------------------------------------------------------------
+void upsample_stage(Stage& stage,
+                    core::BlockKernels const& kernels,
+                    core::ConstChannelView const& in,
+                    mut_real* out)
+{
+    i32 const num      = in.num_samples;
+    i32 const num_taps = stage.num_taps;
+    mut_real* history  = stage.up_history.data();
+    for (mut_i32 i = 0; i < num; ++i)
+        history[num_taps - 1 + i] = in.data[i * in.stride];
+
+    real const* even = stage.even_out.data();
+    real const* odd  = history + num_taps / 2;
+    kernels.fir(history, stage.even_taps.data(), stage.even_out.data(),
+                num_taps, num);
+    if (!stage.halfband)
+    {
+        kernels.fir(history, stage.odd_taps.data(), stage.odd_out.data(),
+                    num_taps, num);
+        odd = stage.odd_out.data();
+    }
+
+    for (mut_i32 i = 0; i < num; ++i)
+    {
+        out[2 * i]     = even[i];
+        out[2 * i + 1] = odd[i];
+    }
+
+    auto const kept = static_cast<size_t>(num_taps - 1);
+    std::memmove(history, history + num, kept * sizeof(mut_real));
+}
+
+//-----------------------------------------------------------------------------
+void downsample_stage(Stage& stage,
+                      core::BlockKernels const& kernels,
+                      core::ConstChannelView const& in,
+                      core::MutChannelView const& out)
+{
+    i32 const num          = out.num_samples;
+    i32 const num_taps     = stage.num_taps;
+    mut_real* even_history = stage.down_even_history.data();
+    mut_real* odd_history  = stage.down_odd_history.data();
+
+    // The odd branch sees its input one sample later, hence its additional
+    // history sample.
+    for (mut_i32 i = 0; i < num; ++i)
+    {
+        even_history[num_taps - 1 + i] = in.data[2 * i * in.stride];
+        odd_history[num_taps + i]      = in.data[(2 * i + 1) * in.stride];
+    }
+
+    real const* even = stage.even_out.data();
+    real const* odd  = odd_history + num_taps / 2;
+    kernels.fir(even_history, stage.even_taps.data(), stage.even_out.data(),
+                num_taps, num);
+    if (!stage.halfband)
+    {
+        kernels.fir(odd_history, stage.odd_taps.data(), stage.odd_out.data(),
+                    num_taps, num);
+        odd = stage.odd_out.data();
+    }
+
+    for (mut_i32 i = 0; i < num; ++i)
+        out.data[i * out.stride] = real(0.5) * (even[i] + odd[i]);
+
+    auto const kept = static_cast<size_t>(num_taps - 1);
+    std::memmove(even_history, even_history + num, kept * sizeof(mut_real));
+    std::memmove(odd_history, odd_history + num,
+                 (kept + 1) * sizeof(mut_real));
+}
+
+//-----------------------------------------------------------------------------
+void copy(core::ConstChannelView const& in, core::MutChannelView const& out)
+{
+    for (mut_i32 i = 0; i < out.num_samples; ++i)
+        out.data[i * out.stride] = in.data[i * in.stride];
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+Oversampler OversamplerImpl::create(i32 factor,
+                                    i32 max_block_size,
+                                    Oversampler::Response response)
+{
+    assert(factor == 1 || factor == 2 || factor == 4 || factor == 8);
+
+    Oversampler self;
+    self.factor         = factor;
+    self.max_block_size = max_block_size;
+    self.response       = response;
+
+    bool const linear = response == Oversampler::Response::LinearPhase;
+    mut_i32 rate      = 1;
+    for (mut_i32 stage_factor = 2; stage_factor <= factor; stage_factor *= 2)
+    {
+        i32 const k    = stage_factor == 2 ? FIRST_STAGE_K : LATER_STAGE_K;
+        auto prototype = design_halfband(k);
+        if (!linear)
+            prototype = to_minimum_phase(prototype);
+
+        // Upsampler and downsampler both delay by the prototype's group delay
+        // at twice the input rate of the stage.
+        self.latency += static_cast<real>(group_delay_at_dc(prototype) / rate);
+        self.stages.push_back(
+            create_stage(prototype, linear, max_block_size * rate));
+        rate *= 2;
+    }
+
+    auto const size = static_cast<size_t>(max_block_size * factor);
+    self.buffer.assign(size, real(0.));
+    self.work.assign(size / 2, real(0.));
+    return self;
+}
+
+//-----------------------------------------------------------------------------
+void OversamplerImpl::reset(Oversampler& self)
+{
+    for (auto& stage : self.stages)
+    {
+        std::fill(stage.up_history.begin(), stage.up_history.end(), real(0.));
+        std::fill(stage.down_even_history.begin(),
+                  stage.down_even_history.end(), real(0.));
+        std::fill(stage.down_odd_history.begin(),
+                  stage.down_odd_history.end(), real(0.));
+    }
+}
+
+//-----------------------------------------------------------------------------
+real OversamplerImpl::latency(Oversampler const& self)
+{
+    return self.latency;
+}
+
+//-----------------------------------------------------------------------------
+core::MutChannelView OversamplerImpl::upsample(Oversampler& self,
+                                               core::ConstChannelView const& in)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::Oversampler);
+
+    using core::BufferViewImpl;
+
+    assert(in.num_samples <= self.max_block_size);
+    auto const num_stages = static_cast<i32>(self.stages.size());
+    auto const result     = BufferViewImpl::channel(
+        self.buffer.data(), in.num_samples * self.factor);
+    if (num_stages == 0)
+    {
+        copy(in, result);
+        return result;
+    }
+
+    // Alternates between work and buffer, the last stage writes buffer.
+    auto const& kernels        = core::CpuDispatchImpl::kernels();
+    core::ConstChannelView src = in;
+    for (mut_i32 s = 0; s < num_stages; ++s)
+    {
+        bool const to_buffer = (num_stages - 1 - s) % 2 == 0;
+        mut_real* dst = to_buffer ? self.buffer.data() : self.work.data();
+        upsample_stage(self.stages[s], kernels, src, dst);
+        src = BufferViewImpl::as_const(
+            BufferViewImpl::channel(dst, src.num_samples * 2));
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+void OversamplerImpl::downsample(Oversampler& self,
+                                 core::ConstChannelView const& in,
+                                 core::MutChannelView const& out)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::Oversampler);
+
+    using core::BufferViewImpl;
+
+    assert(out.num_samples <= self.max_block_size);
+    assert(in.num_samples == out.num_samples * self.factor);
+    auto const num_stages = static_cast<i32>(self.stages.size());
+    if (num_stages == 0)
+        return copy(in, out);
+
+    // Alternates between work and buffer, the first stage writes out. Stages
+    // only read in before writing, so in may be buffer.
+    auto const& kernels        = core::CpuDispatchImpl::kernels();
+    core::ConstChannelView src = in;
+    for (mut_i32 s = num_stages - 1; s > 0; --s)
+    {
+        bool const to_work = (num_stages - 1 - s) % 2 == 0;
+        mut_real* dst      = to_work ? self.work.data() : self.buffer.data();
+        auto const half    = BufferViewImpl::channel(dst, src.num_samples / 2);
+        downsample_stage(self.stages[s], kernels, src, half);
+        src = BufferViewImpl::as_const(half);
+    }
+    downsample_stage(self.stages[0], kernels, src, out);
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::filtering
@@ -1,36 +1,58 @@
 // Copyright René Hansen 2016.
 
 #include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#include "ha/dsp_tool_box/core/coefficient_cache.h"
+#include "ha/dsp_tool_box/core/instrumentation.h"
+#include <array>
 
 namespace ha::dtb::modulation {
+namespace {
+
+//-----------------------------------------------------------------------------
+using adsr_key   = std::array<mut_real, 4>;
+using adsr_cache = core::CoefficientCache<adsr_key, adsr_envelope>;
+
+adsr_cache& envelope_cache()
+{
+    static adsr_cache cache;
+    return cache;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
 
 //-----------------------------------------------------------------------------
 //	adsr_envelope
 //-----------------------------------------------------------------------------
 real adsr_envelope::get_value(context& data) const
 {
-    mut_real value = MIN_VALUE;
+    return evaluate(get_segment(data));
+}
+
+//-----------------------------------------------------------------------------
+adsr_envelope::segment adsr_envelope::get_segment(context& data) const
+{
     switch (data.stage)
     {
         case stages::STAGE_SUSTAIN:
-            value = sustain(data);
-            break;
+            return sustain(data);
         case stages::STAGE_ATTACK:
-            value = attack(data);
-            break;
+            return attack(data);
         case stages::STAGE_DECAY:
-            value = decay(data);
-            break;
+            return decay(data);
         case stages::STAGE_RELEASE:
-            value = release(data);
-            break;
+            return release(data);
         case stages::STAGE_BEFORE_TRIGGER:
         default:
-            value = MIN_VALUE;
-            break;
+            return {real(0.), MIN_VALUE, MIN_VALUE, false};
     }
+}
 
-    return value;
+//-----------------------------------------------------------------------------
+real adsr_envelope::evaluate(segment const& seg)
+{
+    real curve = seg.eased ? shape(seg.x) : seg.x;
+    return seg.from + (seg.to - seg.from) * curve;
 }
 
 //-----------------------------------------------------------------------------
@@ -44,17 +66,18 @@ void adsr_envelope::update_value(real new_value, value& value)
 }
 
 //-----------------------------------------------------------------------------
-real adsr_envelope::attack(context& data) const
+adsr_envelope::segment adsr_envelope::attack(context& data) const
 {
     data.stage = stages::STAGE_ATTACK;
     if (data.time_seconds > att_seconds.first)
         return decay(data);
 
-    return data.time_seconds * att_seconds.second;
+    real value = data.time_seconds * att_seconds.second;
+    return {value, MIN_VALUE, MAX_VALUE, false};
 }
 
 //-----------------------------------------------------------------------------
-real adsr_envelope::decay(context& data) const
+adsr_envelope::segment adsr_envelope::decay(context& data) const
 {
     data.stage = stages::STAGE_DECAY;
     data.time_seconds -= att_seconds.first;
@@ -62,18 +85,18 @@ real adsr_envelope::decay(context& data) const
         return sustain(data);
 
     real value = data.time_seconds * dec_seconds.second;
-    return (sus_normalized - MAX_VALUE) * shape(value) + MAX_VALUE;
+    return {value, MAX_VALUE, sus_normalized, true};
 }
 
 //-----------------------------------------------------------------------------
-inline real adsr_envelope::sustain(context& data) const
+inline adsr_envelope::segment adsr_envelope::sustain(context& data) const
 {
     data.stage = stages::STAGE_SUSTAIN;
-    return sus_normalized;
+    return {real(0.), sus_normalized, sus_normalized, false};
 }
 
 //-----------------------------------------------------------------------------
-real adsr_envelope::release(context& data) const
+adsr_envelope::segment adsr_envelope::release(context& data) const
 {
     /*!
     The Fourth cycle is 'release' starting when key is released.
@@ -82,22 +105,42 @@ real adsr_envelope::release(context& data) const
     */
     data.stage = stages::STAGE_RELEASE;
     if (data.time_seconds > rel_seconds.first)
-        return MIN_VALUE;
+        return {real(0.), MIN_VALUE, MIN_VALUE, false};
 
     real value = data.time_seconds * rel_seconds.second;
-    return data.release_value - shape(value) * data.release_value;
+    return {value, data.release_value, MIN_VALUE, true};
 }
 
 //-----------------------------------------------------------------------------
-real adsr_envelope::shape(real x_val) const
+real adsr_envelope::shape(real x_val)
 {
     return easing::ease_virus_ti<real>(x_val);
 }
 
 //-----------------------------------------------------------------------------
-//	adsr_envelope_processor
+std::shared_ptr<adsr_envelope const>
+adsr_envelope::intern(real att, real dec, real sus, real rel)
+{
+    return envelope_cache().intern({att, dec, sus, rel}, [](adsr_key key) {
+        adsr_envelope adsr;
+        adsr.set_att(key[0]);
+        adsr.set_dec(key[1]);
+        adsr.set_sus(key[2]);
+        adsr.set_rel(key[3]);
+        return adsr;
+    });
+}
+
 //-----------------------------------------------------------------------------
-void adsr_envelope_processor::trigger()
+std::size_t adsr_envelope::collect_interned()
+{
+    return envelope_cache().collect();
+}
+
+//-----------------------------------------------------------------------------
+//	adsr_envelope_voice
+//-----------------------------------------------------------------------------
+void adsr_envelope_voice::trigger()
 {
     current_data.stage         = adsr_envelope::stages::STAGE_ATTACK;
     current_data.release_value = adsr_envelope::MAX_VALUE;
@@ -105,20 +148,83 @@ void adsr_envelope_processor::trigger()
 }
 
 //-----------------------------------------------------------------------------
-real adsr_envelope_processor::read(real time_seconds) const
+real adsr_envelope_voice::read(adsr_envelope const& adsr, real time_seconds)
 {
+    HA_DTB_PROFILE_SCOPE(core::Probe::AdsrEnvelope);
+
     current_data.time_seconds = time_seconds;
     current_value             = adsr.get_value(current_data);
+    HA_DTB_PROFILE_COUNT_AT(adsr_stage_voices, current_data.stage);
     return current_value;
 }
 
 //-----------------------------------------------------------------------------
-void adsr_envelope_processor::release()
+core::BlockState adsr_envelope_voice::read(adsr_envelope const& adsr,
+                                           real time_seconds,
+                                           real sample_rate,
+                                           core::MutChannelView const& out)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::AdsrEnvelope);
+
+    // A segment from a value to the same value stays constant until the
+    // next trigger or release: sustain, before trigger and after release.
+    current_data.time_seconds = time_seconds;
+    auto const first          = adsr.get_segment(current_data);
+    HA_DTB_PROFILE_COUNT_AT(adsr_stage_voices, current_data.stage);
+    if (first.from == first.to)
+    {
+        current_value = first.from;
+        core::BufferViewImpl::fill(out, current_value);
+        return core::BlockStateImpl::constant(current_value);
+    }
+
+    real const seconds_per_sample = real(1.) / sample_rate;
+    for (mut_i32 i = 0; i < out.num_samples; ++i)
+    {
+        real const offset         = static_cast<real>(i) * seconds_per_sample;
+        current_data.time_seconds = time_seconds + offset;
+        current_value             = adsr.get_value(current_data);
+        out.data[i * out.stride]  = current_value;
+    }
+    return core::BlockStateImpl::dynamic();
+}
+
+//-----------------------------------------------------------------------------
+void adsr_envelope_voice::release()
 {
     current_data.stage         = adsr_envelope::stages::STAGE_RELEASE;
     current_data.release_value = current_value;
     current_data.time_seconds  = real(0.);
 }
 
+//-----------------------------------------------------------------------------
+//	adsr_envelope_processor
+//-----------------------------------------------------------------------------
+void adsr_envelope_processor::trigger()
+{
+    voice.trigger();
+}
+
+//-----------------------------------------------------------------------------
+real adsr_envelope_processor::read(real time_seconds) const
+{
+    return voice.read(adsr, time_seconds);
+}
+
+//-----------------------------------------------------------------------------
+core::BlockState
+adsr_envelope_processor::read(real time_seconds,
+                              real sample_rate,
+                              core::MutChannelView const& out) const
+{
+    return voice.read(adsr, time_seconds, sample_rate, out);
+}
+
+//-----------------------------------------------------------------------------
+void adsr_envelope_processor::release()
+{
+    voice.release();
+}
+
 //-----------------------------------------------------------------------------
 } // namespace ha::dtb::modulation
@@ -0,0 +1,80 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/modulation/adsr_envelope_bank.h"
+#include "ha/dsp_tool_box/core/cpu_dispatch.h"
+#include "ha/dsp_tool_box/core/instrumentation.h"
+#include <cassert>
+
+namespace ha::dtb::modulation {
+
+//-----------------------------------------------------------------------------
+//	adsr_envelope_bank
+//-----------------------------------------------------------------------------
+adsr_envelope_bank::adsr_envelope_bank(i32 num_voices)
+: contexts(static_cast<size_t>(num_voices),
+           {adsr_envelope::stages::STAGE_BEFORE_TRIGGER, real(0.), real(0.)})
+, values(static_cast<size_t>(num_voices), real(0.))
+, x(static_cast<size_t>(num_voices), real(0.))
+, from(static_cast<size_t>(num_voices), real(0.))
+, to(static_cast<size_t>(num_voices), real(0.))
+, eased(static_cast<size_t>(num_voices), 0)
+{
+}
+
+//-----------------------------------------------------------------------------
+void adsr_envelope_bank::trigger(i32 voice)
+{
+    auto& context         = contexts[voice];
+    context.stage         = adsr_envelope::stages::STAGE_ATTACK;
+    context.release_value = adsr_envelope::MAX_VALUE;
+    context.time_seconds  = real(0.);
+}
+
+//-----------------------------------------------------------------------------
+void adsr_envelope_bank::release(i32 voice)
+{
+    auto& context         = contexts[voice];
+    context.stage         = adsr_envelope::stages::STAGE_RELEASE;
+    context.release_value = values[voice];
+    context.time_seconds  = real(0.);
+}
+
+//-----------------------------------------------------------------------------
+void adsr_envelope_bank::read(adsr_envelope const& adsr,
+                              real const* time_seconds,
+                              mut_real* out)
+{
+    read(adsr, core::BufferViewImpl::channel(time_seconds, size()),
+         core::BufferViewImpl::channel(out, size()));
+}
+
+//-----------------------------------------------------------------------------
+void adsr_envelope_bank::read(adsr_envelope const& adsr,
+                              core::ConstChannelView const& time_seconds,
+                              core::MutChannelView const& out)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::AdsrEnvelopeBank);
+
+    assert(time_seconds.num_samples == size() && out.num_samples == size());
+    i32 const num = size();
+    for (mut_i32 i = 0; i < num; ++i)
+    {
+        auto& context        = contexts[i];
+        context.time_seconds = time_seconds.data[i * time_seconds.stride];
+        auto const seg       = adsr.get_segment(context);
+        x[i]                 = seg.x;
+        from[i]              = seg.from;
+        to[i]                = seg.to;
+        eased[i]             = seg.eased ? 1 : 0;
+        HA_DTB_PROFILE_COUNT_AT(adsr_stage_voices, context.stage);
+    }
+
+    core::CpuDispatchImpl::kernels().evaluate_segments(
+        x.data(), from.data(), to.data(), eased.data(), values.data(), num);
+
+    for (mut_i32 i = 0; i < num; ++i)
+        out.data[i * out.stride] = values[i];
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
@@ -0,0 +1,130 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/modulation/adsr_envelope_compact_bank.h"
+#include "ha/dsp_tool_box/core/cpu_dispatch.h"
+#include "ha/dsp_tool_box/core/instrumentation.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace ha::dtb::modulation {
+namespace {
+
+//-----------------------------------------------------------------------------
+//! Voices evaluated per kernel call, keeps the scratch buffers on the stack
+constexpr i32 CHUNK_SIZE = 256;
+
+using stages_t = adsr_envelope::stages;
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+//	adsr_envelope_compact_bank
+//-----------------------------------------------------------------------------
+adsr_envelope_compact_bank::adsr_envelope_compact_bank(i32 num_voices)
+: stages(static_cast<size_t>(num_voices),
+         static_cast<mut_u8>(stages_t::STAGE_BEFORE_TRIGGER))
+, samples(static_cast<size_t>(num_voices), 0)
+, release_levels(static_cast<size_t>(num_voices), 0)
+{
+}
+
+//-----------------------------------------------------------------------------
+void adsr_envelope_compact_bank::trigger(i32 voice)
+{
+    stages[voice]         = static_cast<mut_u8>(stages_t::STAGE_ATTACK);
+    samples[voice]        = 0;
+    release_levels[voice] = static_cast<mut_u16>(ONE);
+}
+
+//-----------------------------------------------------------------------------
+void adsr_envelope_compact_bank::release(adsr_envelope const& adsr,
+                                         real sample_rate,
+                                         i32 voice)
+{
+    auto context      = context_of(sample_rate, voice);
+    real const value  = adsr.get_value(context);
+    real const level  = std::clamp(value, real(0.), real(1.));
+    auto const scaled = std::lround(level * static_cast<real>(ONE));
+
+    stages[voice]         = static_cast<mut_u8>(stages_t::STAGE_RELEASE);
+    samples[voice]        = 0;
+    release_levels[voice] = static_cast<mut_u16>(scaled);
+}
+
+//-----------------------------------------------------------------------------
+void adsr_envelope_compact_bank::read(adsr_envelope const& adsr,
+                                      real sample_rate,
+                                      mut_real* out)
+{
+    read(adsr, sample_rate, core::BufferViewImpl::channel(out, size()));
+}
+
+//-----------------------------------------------------------------------------
+void adsr_envelope_compact_bank::read(adsr_envelope const& adsr,
+                                      real sample_rate,
+                                      core::MutChannelView const& out)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::AdsrEnvelopeBank);
+
+    assert(out.num_samples == size());
+    mut_real x[CHUNK_SIZE];
+    mut_real from[CHUNK_SIZE];
+    mut_real to[CHUNK_SIZE];
+    mut_u8 eased[CHUNK_SIZE];
+    mut_real values[CHUNK_SIZE];
+
+    auto const& kernels = core::CpuDispatchImpl::kernels();
+    i32 const num       = size();
+    for (mut_i32 begin = 0; begin < num; begin += CHUNK_SIZE)
+    {
+        i32 const count = std::min(CHUNK_SIZE, num - begin);
+        for (mut_i32 i = 0; i < count; ++i)
+        {
+            i32 const voice = begin + i;
+            auto context    = context_of(sample_rate, voice);
+            auto const seg  = adsr.get_segment(context);
+            x[i]            = seg.x;
+            from[i]         = seg.from;
+            to[i]           = seg.to;
+            eased[i]        = seg.eased ? 1 : 0;
+            stages[voice]   = static_cast<mut_u8>(context.stage);
+            HA_DTB_PROFILE_COUNT_AT(adsr_stage_voices, context.stage);
+        }
+
+        // Contiguous channels are written by the kernel directly.
+        mut_real* dst = out.stride == 1 ? out.data + begin : values;
+        kernels.evaluate_segments(x, from, to, eased, dst, count);
+        if (dst == values)
+        {
+            for (mut_i32 i = 0; i < count; ++i)
+                out.data[(begin + i) * out.stride] = values[i];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void adsr_envelope_compact_bank::advance(i32 num_samples)
+{
+    // Saturates instead of wrapping, a voice past its last stage stays there.
+    u32 const max_samples = std::numeric_limits<mut_u32>::max();
+    u32 const step        = static_cast<mut_u32>(num_samples);
+    for (auto& count : samples)
+        count = count < max_samples - step ? count + step : max_samples;
+}
+
+//-----------------------------------------------------------------------------
+adsr_envelope::context
+adsr_envelope_compact_bank::context_of(real sample_rate, i32 voice) const
+{
+    double const seconds = static_cast<double>(samples[voice]) / sample_rate;
+    real const level     = static_cast<real>(release_levels[voice]) /
+                           static_cast<real>(ONE);
+    return {static_cast<stages_t>(stages[voice]), static_cast<real>(seconds),
+            level};
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
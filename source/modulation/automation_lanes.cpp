@@ -0,0 +1,180 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/modulation/automation_lanes.h"
+#include "ha/dsp_tool_box/core/instrumentation.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ha::dtb::modulation {
+namespace {
+
+//-----------------------------------------------------------------------------
+// Relative distance at which a smoother counts as settled. The one-pole can
+// stall a few ulps away from its input, so it is snapped to the value.
+constexpr real SETTLE_EPSILON = real(1e-6);
+
+//-----------------------------------------------------------------------------
+bool is_settled(real z, real value)
+{
+    return std::abs(z - value) <=
+           SETTLE_EPSILON * std::max(real(1.), std::abs(value));
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Renders the ramps and smooths them in the same pass with the recurrence
+ * of OnePoleBankImpl::process_filter. A pole of 0 passes the ramps through
+ * unchanged.
+ */
+real render_ramps(AutomationPoint const* points,
+                  i32 num_points,
+                  real start_value,
+                  real a,
+                  real b,
+                  mut_real& z,
+                  core::MutChannelView const& out)
+{
+    i32 const num_samples = out.num_samples;
+    i32 const stride      = out.stride;
+    auto const offset_of  = [num_samples](AutomationPoint const& point) {
+        return std::clamp(point.offset, 0, num_samples - 1);
+    };
+    auto const write = [a, b, stride, &z, &out](i32 n, real sample) {
+        real const filtered  = (sample * b) + (z * a);
+        z                    = sample == z ? z : filtered;
+        out.data[n * stride] = z;
+    };
+
+    // The previous block ended at offset -1 with start_value.
+    mut_real value = start_value;
+    mut_i32 anchor = -1;
+    for (mut_i32 p = 0; p < num_points; ++p)
+    {
+        // Points at the same offset collapse to the last one.
+        i32 const offset = offset_of(points[p]);
+        if (p + 1 < num_points && offset_of(points[p + 1]) == offset)
+            continue;
+
+        real const target = points[p].value;
+        real const step =
+            (target - value) / static_cast<real>(std::max(offset - anchor, 1));
+        for (mut_i32 n = anchor + 1; n < offset; ++n)
+            write(n, value + step * static_cast<real>(n - anchor));
+
+        write(offset, target);
+        value  = target;
+        anchor = offset;
+    }
+
+    for (mut_i32 n = anchor + 1; n < num_samples; ++n)
+        write(n, value);
+
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+AutomationLanes AutomationLanesImpl::create(i32 num_lanes, i32 max_points)
+{
+    auto const num = static_cast<size_t>(num_lanes);
+    AutomationLanes self;
+    self.max_points = max_points;
+    self.points.assign(num * static_cast<size_t>(max_points),
+                       AutomationPoint());
+    self.num_points.assign(num, 0);
+    self.values.assign(num, real(0.));
+    self.smoothers = filtering::OnePoleBankImpl::create(num_lanes, real(0.));
+    return self;
+}
+
+//-----------------------------------------------------------------------------
+void AutomationLanesImpl::set_value(AutomationLanes& self, i32 lane, real value)
+{
+    self.values[lane] = value;
+    filtering::OnePoleBankImpl::reset(self.smoothers, lane, value);
+}
+
+//-----------------------------------------------------------------------------
+bool AutomationLanesImpl::add_point(AutomationLanes& self,
+                                    i32 lane,
+                                    i32 offset,
+                                    real value)
+{
+    auto& count = self.num_points[lane];
+    if (count >= self.max_points)
+        return false;
+
+    auto* points = self.points.data() + lane * self.max_points;
+    assert(offset >= 0);
+    assert(count == 0 || points[count - 1].offset <= offset);
+    points[count++] = {offset, value};
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void AutomationLanesImpl::set_smoothing(AutomationLanes& self, i32 lane, real a)
+{
+    filtering::OnePoleBankImpl::update_pole(self.smoothers, lane, a);
+    filtering::OnePoleBankImpl::reset(self.smoothers, lane, self.values[lane]);
+}
+
+//-----------------------------------------------------------------------------
+void AutomationLanesImpl::render(AutomationLanes& self,
+                                 mut_real* out,
+                                 i32 num_samples)
+{
+    auto const block =
+        core::BufferViewImpl::contiguous(out, size(self), num_samples);
+    render(self, block);
+}
+
+//-----------------------------------------------------------------------------
+void AutomationLanesImpl::render(AutomationLanes& self,
+                                 core::MutBlockView const& block,
+                                 core::BlockState* states)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::AutomationLanes);
+
+    assert(block.num_channels == size(self));
+    for (mut_i32 lane = 0; lane < block.num_channels; ++lane)
+    {
+        auto const out    = core::BufferViewImpl::channel(block, lane);
+        auto& count       = self.num_points[lane];
+        auto& value       = self.values[lane];
+        bool const smooth = self.smoothers.a[lane] != real(0.);
+        bool const settled =
+            !smooth || is_settled(self.smoothers.z[lane], value);
+
+        if (count == 0 && settled)
+        {
+            if (smooth)
+                filtering::OnePoleBankImpl::reset(self.smoothers, lane, value);
+
+            core::BufferViewImpl::fill(out, value);
+            if (states)
+                states[lane] = core::BlockStateImpl::constant(value);
+            continue;
+        }
+
+        auto const* points = self.points.data() + lane * self.max_points;
+        value = render_ramps(points, count, value, self.smoothers.a[lane],
+                             self.smoothers.b[lane], self.smoothers.z[lane],
+                             out);
+        count = 0;
+
+        if (states)
+            states[lane] = core::BlockStateImpl::dynamic();
+    }
+}
+
+//-----------------------------------------------------------------------------
+i32 AutomationLanesImpl::size(AutomationLanes const& self)
+{
+    return static_cast<i32>(self.values.size());
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
@@ -0,0 +1,135 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/modulation/compact_phase_bank.h"
+#include "ha/dsp_tool_box/core/instrumentation.h"
+#include <array>
+#include <cassert>
+#include <cmath>
+
+namespace ha::dtb::modulation {
+namespace {
+
+//-----------------------------------------------------------------------------
+constexpr double TWO_POW_32 = 4294967296.;
+constexpr real STEP         = real(1.) / real(CompactPhaseBank::ONE);
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+CompactPhaseBank CompactPhaseBankImpl::create(i32 num_phases, i32 num_groups)
+{
+    assert(num_groups > 0 && num_groups <= CompactPhaseBank::MAX_GROUPS);
+
+    auto const num = static_cast<size_t>(num_phases);
+    CompactPhaseBank self;
+    self.values.assign(num, 0);
+    self.groups.assign(num, 0);
+    self.overflows.assign(num, 0);
+    self.increments.assign(static_cast<size_t>(num_groups), 0);
+    self.residues.assign(static_cast<size_t>(num_groups), 0);
+    return self;
+}
+
+//-----------------------------------------------------------------------------
+void CompactPhaseBankImpl::set_group_phase(CompactPhaseBank& self,
+                                           i32 group,
+                                           Phase const& phase)
+{
+    assert(phase.mode != Phase::SyncMode::ProjectSync);
+    set_group_increment(self, group, PhaseImpl::increment(phase));
+}
+
+//-----------------------------------------------------------------------------
+void CompactPhaseBankImpl::set_group_increment(CompactPhaseBank& self,
+                                               i32 group,
+                                               real increment)
+{
+    // Increments of 1 and more wrap, like the phase itself.
+    double const fraction  = increment - std::floor(increment);
+    double const scaled    = std::round(fraction * TWO_POW_32);
+    self.increments[group] = static_cast<mut_u32>(
+        static_cast<mut_u64>(scaled) & 0xFFFFFFFFu);
+}
+
+//-----------------------------------------------------------------------------
+void CompactPhaseBankImpl::set_group(CompactPhaseBank& self,
+                                     i32 index,
+                                     i32 group)
+{
+    assert(group >= 0 && group < static_cast<i32>(self.increments.size()));
+    self.groups[index] = static_cast<mut_u8>(group);
+}
+
+//-----------------------------------------------------------------------------
+void CompactPhaseBankImpl::set_value(CompactPhaseBank& self,
+                                     i32 index,
+                                     real value)
+{
+    real const fraction = value - std::floor(value);
+    auto const rounded  = static_cast<mut_u32>(
+        std::lround(fraction * static_cast<real>(CompactPhaseBank::ONE)));
+    self.values[index] = static_cast<mut_u16>(rounded & 0xFFFFu);
+}
+
+//-----------------------------------------------------------------------------
+real CompactPhaseBankImpl::value(CompactPhaseBank const& self, i32 index)
+{
+    return static_cast<real>(self.values[index]) * STEP;
+}
+
+//-----------------------------------------------------------------------------
+void CompactPhaseBankImpl::advance(CompactPhaseBank& self, i32 num_samples)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::PhaseBank);
+
+    // Whole steps of values per group. All phases of a group share the
+    // fraction below one step, so they advance by the same amount.
+    std::array<mut_u32, CompactPhaseBank::MAX_GROUPS> steps;
+    auto const num_groups = self.increments.size();
+    for (size_t g = 0; g < num_groups; ++g)
+    {
+        u64 const total = static_cast<mut_u64>(self.increments[g]) *
+                              static_cast<mut_u64>(num_samples) +
+                          self.residues[g];
+        // Only the fraction of a cycle matters, whole cycles wrap.
+        steps[g]          = static_cast<mut_u32>((total >> 16) & 0xFFFFu);
+        self.residues[g]  = static_cast<mut_u32>(total & 0xFFFFu);
+        bool const cycles = (total >> 32) != 0;
+        if (cycles)
+            steps[g] |= CompactPhaseBank::ONE;
+    }
+
+    i32 const num = size(self);
+    for (mut_i32 i = 0; i < num; ++i)
+    {
+        u32 const sum     = self.values[i] + steps[self.groups[i]];
+        self.values[i]    = static_cast<mut_u16>(sum & 0xFFFFu);
+        self.overflows[i] = static_cast<mut_u8>(sum >= CompactPhaseBank::ONE);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void CompactPhaseBankImpl::read(CompactPhaseBank const& self, mut_real* out)
+{
+    read(self, core::BufferViewImpl::channel(out, size(self)));
+}
+
+//-----------------------------------------------------------------------------
+void CompactPhaseBankImpl::read(CompactPhaseBank const& self,
+                                core::MutChannelView const& out)
+{
+    assert(out.num_samples == size(self));
+    i32 const num = size(self);
+    for (mut_i32 i = 0; i < num; ++i)
+        out.data[i * out.stride] = static_cast<real>(self.values[i]) * STEP;
+}
+
+//-----------------------------------------------------------------------------
+i32 CompactPhaseBankImpl::size(CompactPhaseBank const& self)
+{
+    return static_cast<i32>(self.values.size());
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
@@ -1,6 +1,7 @@
 // Copyright(c) 2021 Hansen Audio.
 
 #include "ha/dsp_tool_box/modulation/modulation_phase.h"
+#include "ha/dsp_tool_box/core/instrumentation.h"
 #include <cassert>
 #include <math.h>
 
@@ -80,6 +81,8 @@ void update_project_sync(mut_real& phase,
 //-----------------------------------------------------------------------------
 bool PhaseImpl::advance(Phase const& self, mut_real& phase, i32 num_samples)
 {
+    HA_DTB_PROFILE_SCOPE(core::Probe::Phase);
+
     switch (self.mode)
     {
         case Phase::SyncMode::Free:
@@ -92,6 +95,8 @@ bool PhaseImpl::advance(Phase const& self, mut_real& phase, i32 num_samples)
             real old_phase = phase;
             update_project_sync(phase, self.project_time, self.rate);
             bool did_overflow = phase < old_phase;
+            if (did_overflow)
+                HA_DTB_PROFILE_COUNT(phase_overflows);
             return did_overflow;
         }
         default:
@@ -99,7 +104,45 @@ bool PhaseImpl::advance(Phase const& self, mut_real& phase, i32 num_samples)
             break;
     }
 
-    return check_overflow(phase, PHASE_MAX);
+    bool const did_overflow = check_overflow(phase, PHASE_MAX);
+    if (did_overflow)
+        HA_DTB_PROFILE_COUNT(phase_overflows);
+
+    return did_overflow;
+}
+
+//-----------------------------------------------------------------------------
+bool PhaseImpl::advance(Phase const& self,
+                        mut_real& value,
+                        core::MutChannelView const& out)
+{
+    core::BlockState state;
+    return advance(self, value, out, state);
+}
+
+//-----------------------------------------------------------------------------
+bool PhaseImpl::advance(Phase const& self,
+                        mut_real& value,
+                        core::MutChannelView const& out,
+                        core::BlockState& state)
+{
+    // Every sample is computed from value directly, no loop carried
+    // dependency and no accumulated error.
+    real const inc = self.mode == Phase::SyncMode::ProjectSync
+                         ? real(0.)
+                         : increment(self);
+    real const start = self.mode == Phase::SyncMode::ProjectSync
+                           ? normalise_phase(self.project_time * self.rate)
+                           : value;
+    for (mut_i32 i = 0; i < out.num_samples; ++i)
+        out.data[i * out.stride] =
+            normalise_phase(start + static_cast<real>(i) * inc);
+
+    // Reports the value written to out, a start of 1 wraps to 0.
+    state = inc == real(0.)
+                ? core::BlockStateImpl::constant(normalise_phase(start))
+                : core::BlockStateImpl::dynamic();
+    return advance(self, value, out.num_samples);
 }
 
 //-----------------------------------------------------------------------------
@@ -117,6 +160,15 @@ bool PhaseImpl::advance_one_shot(Phase const& self,
     return is_overflow;
 }
 
+//-----------------------------------------------------------------------------
+real PhaseImpl::increment(Phase const& self)
+{
+    if (self.mode == Phase::SyncMode::Free)
+        return self.free_running_factor;
+
+    return self.tempo_synced_factor;
+}
+
 //-----------------------------------------------------------------------------
 void PhaseImpl::set_sample_rate(Phase& self, real value)
 {
@@ -0,0 +1,335 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/modulation/mseg_envelope.h"
+#include "ha/dsp_tool_box/core/instrumentation.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ha::dtb::modulation {
+namespace {
+
+//-----------------------------------------------------------------------------
+//! 96dB / 20 * log2(10), \sa easing::ease_virus_ti
+constexpr double EASE_MULTIPLICATOR = 96. / 20. * 3.32192809488736234787;
+
+//-----------------------------------------------------------------------------
+void update_coefficients(Mseg& self, i32 index)
+{
+    auto const& segment = self.segments[index];
+    auto& coeffs        = self.coefficients[index];
+
+    coeffs.num_samples = static_cast<double>(segment.duration_seconds) *
+                         static_cast<double>(self.sample_rate);
+    coeffs.x_increment =
+        coeffs.num_samples > 0. ? 1. / coeffs.num_samples : 0.;
+    coeffs.ease_ratio = std::exp2(-EASE_MULTIPLICATOR * coeffs.x_increment);
+}
+
+//-----------------------------------------------------------------------------
+void enter_segment(
+    Mseg const& self, MsegVoice& voice, i32 index, real from, double position)
+{
+    auto const& coeffs = self.coefficients[index];
+    voice.segment      = index;
+    voice.position     = position;
+    voice.from         = from;
+    voice.holding      = false;
+    voice.ease_state =
+        std::exp2(-EASE_MULTIPLICATOR * position * coeffs.x_increment);
+}
+
+//-----------------------------------------------------------------------------
+void hold(MsegVoice& voice, real value)
+{
+    voice.value   = value;
+    voice.holding = true;
+}
+
+//-----------------------------------------------------------------------------
+void leave_segment(Mseg const& self, MsegVoice& voice)
+{
+    i32 const current = voice.segment;
+    i32 const next    = current + 1;
+    real const level  = self.segments[current].level;
+    double const position =
+        voice.position - self.coefficients[current].num_samples;
+
+    if (voice.gate)
+    {
+        if (current == self.loop_end && self.loop_begin != Mseg::NONE)
+            return enter_segment(self, voice, self.loop_begin, level, position);
+
+        if (current == self.sustain_segment || next == self.release_segment)
+            return hold(voice, level);
+    }
+
+    if (next >= self.num_segments)
+        return hold(voice, level);
+
+    enter_segment(self, voice, next, level, position);
+}
+
+//-----------------------------------------------------------------------------
+void render_run(MsegSegment const& segment,
+                Mseg::Coefficients const& coeffs,
+                MsegVoice& voice,
+                core::MutChannelView const& out)
+{
+    i32 const num    = out.num_samples;
+    i32 const stride = out.stride;
+    real const from  = voice.from;
+    real const delta = segment.level - from;
+    switch (segment.curve)
+    {
+        case MsegCurve::Linear: {
+            double const x_increment = coeffs.x_increment;
+            double const position    = voice.position;
+            for (mut_i32 i = 0; i < num; ++i)
+            {
+                double const x       = (position + i) * x_increment;
+                out.data[i * stride] = from + delta * static_cast<real>(x);
+            }
+            break;
+        }
+        case MsegCurve::Ease: {
+            // 1 - ease(x) = 2^(-multiplicator * x) is a geometric series in
+            // the samples, so one multiplication per sample is enough.
+            double const ratio = coeffs.ease_ratio;
+            double state       = voice.ease_state;
+            for (mut_i32 i = 0; i < num; ++i)
+            {
+                out.data[i * stride] =
+                    from + delta * static_cast<real>(1. - state);
+                state *= ratio;
+            }
+            voice.ease_state = state;
+            break;
+        }
+        case MsegCurve::Hold:
+            core::BufferViewImpl::fill(out, segment.level);
+            break;
+    }
+
+    voice.position += num;
+    voice.value = out.data[(num - 1) * stride];
+}
+
+//-----------------------------------------------------------------------------
+core::BlockState render_voice(Mseg const& self,
+                              MsegVoice& voice,
+                              core::MutChannelView const& out)
+{
+    using core::BufferViewImpl;
+
+    if (voice.holding)
+    {
+        BufferViewImpl::fill(out, voice.value);
+        return core::BlockStateImpl::constant(voice.value);
+    }
+
+    i32 const num_samples  = out.num_samples;
+    mut_i32 done           = 0;
+    mut_i32 empty_segments = 0;
+    while (done < num_samples)
+    {
+        if (voice.holding)
+        {
+            BufferViewImpl::fill(
+                BufferViewImpl::sub_range(out, done, num_samples - done),
+                voice.value);
+            break;
+        }
+
+        auto const& coeffs     = self.coefficients[voice.segment];
+        double const remaining = coeffs.num_samples - voice.position;
+        if (remaining < 0.)
+        {
+            // A loop of segments without duration would never end.
+            if (++empty_segments > self.num_segments)
+                hold(voice, self.segments[voice.segment].level);
+            else
+                leave_segment(self, voice);
+            continue;
+        }
+
+        empty_segments = 0;
+        i32 const left = num_samples - done;
+        i32 const run  = remaining < static_cast<double>(left)
+                             ? static_cast<i32>(remaining) + 1
+                             : left;
+        render_run(self.segments[voice.segment], coeffs, voice,
+                   BufferViewImpl::sub_range(out, done, run));
+        done += run;
+    }
+    return core::BlockStateImpl::dynamic();
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+Mseg MsegImpl::create(real sample_rate)
+{
+    Mseg self;
+    set_sample_rate(self, sample_rate);
+    return self;
+}
+
+//-----------------------------------------------------------------------------
+Mseg MsegImpl::create_adsr(
+    real att, real dec, real sus, real rel, real sample_rate)
+{
+    Mseg self = create(sample_rate);
+    set_segment(self, 0, {att, real(1.), MsegCurve::Linear});
+    set_segment(self, 1, {dec, sus, MsegCurve::Ease});
+    set_segment(self, 2, {rel, real(0.), MsegCurve::Ease});
+    set_num_segments(self, 3);
+    set_sustain_segment(self, 1);
+    set_release_segment(self, 2);
+    return self;
+}
+
+//-----------------------------------------------------------------------------
+void MsegImpl::set_segment(Mseg& self, i32 index, MsegSegment const& segment)
+{
+    assert(index >= 0 && index < Mseg::MAX_SEGMENTS);
+    self.segments[index] = segment;
+    update_coefficients(self, index);
+}
+
+//-----------------------------------------------------------------------------
+void MsegImpl::set_num_segments(Mseg& self, i32 value)
+{
+    self.num_segments = std::clamp(value, i32(0), Mseg::MAX_SEGMENTS);
+}
+
+//-----------------------------------------------------------------------------
+void MsegImpl::set_sustain_segment(Mseg& self, i32 index)
+{
+    self.sustain_segment = index;
+}
+
+//-----------------------------------------------------------------------------
+void MsegImpl::set_loop(Mseg& self, i32 loop_begin, i32 loop_end)
+{
+    assert(loop_begin <= loop_end);
+    self.loop_begin = loop_begin;
+    self.loop_end   = loop_end;
+}
+
+//-----------------------------------------------------------------------------
+void MsegImpl::set_release_segment(Mseg& self, i32 index)
+{
+    self.release_segment = index;
+}
+
+//-----------------------------------------------------------------------------
+void MsegImpl::set_sample_rate(Mseg& self, real value)
+{
+    self.sample_rate = value;
+    for (mut_i32 i = 0; i < Mseg::MAX_SEGMENTS; ++i)
+        update_coefficients(self, i);
+}
+
+//-----------------------------------------------------------------------------
+void MsegImpl::trigger(Mseg const& self, MsegVoice& voice)
+{
+    voice.gate = true;
+    if (self.num_segments == 0)
+        return hold(voice, self.start_level);
+
+    enter_segment(self, voice, 0, self.start_level, 0.);
+    voice.value = self.start_level;
+}
+
+//-----------------------------------------------------------------------------
+void MsegImpl::release(Mseg const& self, MsegVoice& voice)
+{
+    voice.gate = false;
+    if (self.release_segment >= 0 && self.release_segment < self.num_segments)
+        return enter_segment(self, voice, self.release_segment, voice.value,
+                             0.);
+
+    // Without a release segment, continue behind the sustain segment.
+    i32 const next = voice.segment + 1;
+    if (voice.holding && voice.segment != Mseg::NONE &&
+        next < self.num_segments)
+        enter_segment(self, voice, next, voice.value, 0.);
+}
+
+//-----------------------------------------------------------------------------
+core::BlockState MsegImpl::render(Mseg const& self,
+                                  MsegVoice& voice,
+                                  mut_real* out,
+                                  i32 num_samples)
+{
+    return render(self, voice, core::BufferViewImpl::channel(out, num_samples));
+}
+
+//-----------------------------------------------------------------------------
+core::BlockState MsegImpl::render(Mseg const& self,
+                                  MsegVoice& voice,
+                                  core::MutChannelView const& out)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::Mseg);
+
+    return render_voice(self, voice, out);
+}
+
+//-----------------------------------------------------------------------------
+MsegBank MsegBankImpl::create(i32 num_voices)
+{
+    MsegBank self;
+    self.voices.assign(static_cast<size_t>(num_voices), MsegVoice());
+    return self;
+}
+
+//-----------------------------------------------------------------------------
+void MsegBankImpl::trigger(Mseg const& mseg, MsegBank& self, i32 voice)
+{
+    MsegImpl::trigger(mseg, self.voices[voice]);
+}
+
+//-----------------------------------------------------------------------------
+void MsegBankImpl::release(Mseg const& mseg, MsegBank& self, i32 voice)
+{
+    MsegImpl::release(mseg, self.voices[voice]);
+}
+
+//-----------------------------------------------------------------------------
+void MsegBankImpl::render(Mseg const& mseg,
+                          MsegBank& self,
+                          mut_real* out,
+                          i32 num_samples)
+{
+    render(mseg, self,
+           core::BufferViewImpl::contiguous(out, size(self), num_samples));
+}
+
+//-----------------------------------------------------------------------------
+void MsegBankImpl::render(Mseg const& mseg,
+                          MsegBank& self,
+                          core::MutBlockView const& out,
+                          core::BlockState* states)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::MsegBank);
+
+    assert(out.num_channels == size(self));
+    for (mut_i32 i = 0; i < out.num_channels; ++i)
+    {
+        auto const state = render_voice(mseg, self.voices[i],
+                                        core::BufferViewImpl::channel(out, i));
+        if (states)
+            states[i] = state;
+    }
+}
+
+//-----------------------------------------------------------------------------
+i32 MsegBankImpl::size(MsegBank const& self)
+{
+    return static_cast<i32>(self.voices.size());
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
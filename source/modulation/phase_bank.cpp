@@ -0,0 +1,65 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/modulation/phase_bank.h"
+#include "ha/dsp_tool_box/core/cpu_dispatch.h"
+#include "ha/dsp_tool_box/core/instrumentation.h"
+#include <cassert>
+
+namespace ha::dtb::modulation {
+
+//-----------------------------------------------------------------------------
+PhaseBank PhaseBankImpl::create(i32 num_phases)
+{
+    auto const num = static_cast<size_t>(num_phases);
+    PhaseBank self;
+    self.values.assign(num, real(0.));
+    self.increments.assign(num, real(0.));
+    self.overflows.assign(num, 0);
+    return self;
+}
+
+//-----------------------------------------------------------------------------
+void PhaseBankImpl::set_phase(PhaseBank& self, i32 index, Phase const& phase)
+{
+    assert(phase.mode != Phase::SyncMode::ProjectSync);
+    set_increment(self, index, PhaseImpl::increment(phase));
+}
+
+//-----------------------------------------------------------------------------
+void PhaseBankImpl::set_increment(PhaseBank& self, i32 index, real increment)
+{
+    self.increments[index] = increment;
+}
+
+//-----------------------------------------------------------------------------
+void PhaseBankImpl::set_value(PhaseBank& self, i32 index, real value)
+{
+    self.values[index] = value;
+}
+
+//-----------------------------------------------------------------------------
+void PhaseBankImpl::advance(PhaseBank& self, i32 num_samples)
+{
+    HA_DTB_PROFILE_SCOPE(core::Probe::PhaseBank);
+
+    core::CpuDispatchImpl::kernels().advance_phases(
+        self.values.data(), self.increments.data(), self.overflows.data(),
+        num_samples, size(self));
+
+#if HA_DTB_ENABLE_INSTRUMENTATION
+    for (auto overflow : self.overflows)
+    {
+        if (overflow)
+            HA_DTB_PROFILE_COUNT(phase_overflows);
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+i32 PhaseBankImpl::size(PhaseBank const& self)
+{
+    return static_cast<i32>(self.values.size());
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::modulation
@@ -0,0 +1,221 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/synthesis/wavetable_oscillator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <mutex>
+
+namespace ha::dtb::synthesis {
+namespace {
+
+//-----------------------------------------------------------------------------
+using WavetablePtr = std::shared_ptr<Wavetable const>;
+
+constexpr i32 TABLE_MASK       = Wavetable::TABLE_SIZE - 1;
+constexpr i32 NUM_WAVEFORMS    = static_cast<i32>(Waveform::Count);
+constexpr i32 CHUNK_SIZE       = 64;
+constexpr double PI            = 3.14159265358979323846;
+constexpr real NYQUIST_PHASE   = real(0.5);
+constexpr real TABLE_SIZE_REAL = static_cast<real>(Wavetable::TABLE_SIZE);
+
+//-----------------------------------------------------------------------------
+double harmonic_amplitude(Waveform waveform, i32 harmonic)
+{
+    bool const is_odd = (harmonic & 1) == 1;
+    switch (waveform)
+    {
+        case Waveform::Sine:
+            return harmonic == 1 ? 1. : 0.;
+        case Waveform::Saw: {
+            double const sign = is_odd ? 1. : -1.;
+            return sign * 2. / (PI * harmonic);
+        }
+        case Waveform::Square:
+            return is_odd ? 4. / (PI * harmonic) : 0.;
+        case Waveform::Triangle: {
+            if (!is_odd)
+                return 0.;
+            double const sign = ((harmonic - 1) / 2) % 2 == 0 ? 1. : -1.;
+            return sign * 8. / (PI * PI * harmonic * harmonic);
+        }
+        default:
+            return 0.;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Additive synthesis from the top level (one partial) down to level 0. Each
+ * level adds the partials it has on top of the previous one, so every
+ * partial gets summed only once.
+ */
+WavetablePtr build_wavetable(Waveform waveform)
+{
+    auto table      = std::make_shared<Wavetable>();
+    table->waveform = waveform;
+    table->samples.resize(Wavetable::NUM_LEVELS * Wavetable::LEVEL_SIZE);
+
+    std::vector<double> sine(Wavetable::TABLE_SIZE);
+    for (mut_i32 n = 0; n < Wavetable::TABLE_SIZE; ++n)
+        sine[n] = std::sin(2. * PI * n / Wavetable::TABLE_SIZE);
+
+    std::vector<double> sum(Wavetable::TABLE_SIZE, 0.);
+    mut_i32 harmonic = 1;
+    for (mut_i32 level = Wavetable::NUM_LEVELS - 1; level >= 0; --level)
+    {
+        i32 max_harmonic = Wavetable::MAX_HARMONICS >> level;
+        for (; harmonic <= max_harmonic; ++harmonic)
+        {
+            double const amplitude = harmonic_amplitude(waveform, harmonic);
+            if (amplitude == 0.)
+                continue;
+
+            for (mut_i32 n = 0; n < Wavetable::TABLE_SIZE; ++n)
+                sum[n] += amplitude * sine[(harmonic * n) & TABLE_MASK];
+        }
+
+        auto* dst = &table->samples[level * Wavetable::LEVEL_SIZE];
+        for (mut_i32 n = 0; n < Wavetable::TABLE_SIZE; ++n)
+            dst[n] = static_cast<real>(sum[n]);
+        dst[Wavetable::TABLE_SIZE] = dst[0];
+    }
+
+    return table;
+}
+
+//-----------------------------------------------------------------------------
+real const* level_samples(WavetableOscillator const& self, i32 level)
+{
+    return &self.table->samples[level * Wavetable::LEVEL_SIZE];
+}
+
+//-----------------------------------------------------------------------------
+real read_level(real const* samples, real phase)
+{
+    real const position = phase * TABLE_SIZE_REAL;
+    i32 const index     = static_cast<i32>(position);
+    real const fraction = position - static_cast<real>(index);
+    // A phase of exactly 1 wraps around to the first sample.
+    i32 const i0 = index & TABLE_MASK;
+    return samples[i0] + fraction * (samples[i0 + 1] - samples[i0]);
+}
+
+//-----------------------------------------------------------------------------
+real floor_by_cast(real value)
+{
+    // The cast truncates towards zero, negative values are moved down by one
+    // so that a negative increment still wraps into [0, 1).
+    real const truncated = static_cast<real>(static_cast<i32>(value));
+    return truncated > value ? truncated - real(1.) : truncated;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+//  WavetableCache
+//-----------------------------------------------------------------------------
+std::shared_ptr<Wavetable const> WavetableCache::get(Waveform waveform)
+{
+    static std::mutex mutex;
+    static std::array<WavetablePtr, NUM_WAVEFORMS> tables;
+
+    std::lock_guard<std::mutex> const lock(mutex);
+    auto& table = tables.at(static_cast<size_t>(waveform));
+    if (!table)
+        table = build_wavetable(waveform);
+
+    return table;
+}
+
+//-----------------------------------------------------------------------------
+//  WavetableOscillator
+//-----------------------------------------------------------------------------
+WavetableOscillator WavetableOscillatorImpl::create(Waveform waveform)
+{
+    WavetableOscillator self;
+    set_waveform(self, waveform);
+    return self;
+}
+
+//-----------------------------------------------------------------------------
+void WavetableOscillatorImpl::set_waveform(WavetableOscillator& self,
+                                           Waveform waveform)
+{
+    self.table = WavetableCache::get(waveform);
+}
+
+//-----------------------------------------------------------------------------
+i32 WavetableOscillatorImpl::select_level(real increment)
+{
+    real const abs_increment = std::abs(increment);
+    mut_i32 level            = 0;
+    while (level < Wavetable::NUM_LEVELS - 1 &&
+           real(Wavetable::MAX_HARMONICS >> level) * abs_increment >
+               NYQUIST_PHASE)
+    {
+        ++level;
+    }
+
+    return level;
+}
+
+//-----------------------------------------------------------------------------
+real WavetableOscillatorImpl::process(WavetableOscillator const& self,
+                                      real phase,
+                                      real increment)
+{
+    return read_level(level_samples(self, select_level(increment)), phase);
+}
+
+//-----------------------------------------------------------------------------
+void WavetableOscillatorImpl::render(WavetableOscillator const& self,
+                                     real const* phases,
+                                     real increment,
+                                     mut_real* out,
+                                     i32 num_samples)
+{
+    real const* samples = level_samples(self, select_level(increment));
+    for (mut_i32 i = 0; i < num_samples; ++i)
+        out[i] = read_level(samples, phases[i]);
+}
+
+//-----------------------------------------------------------------------------
+void WavetableOscillatorImpl::render(WavetableOscillator const& self,
+                                     modulation::Phase const& phase,
+                                     mut_real& value,
+                                     mut_real* out,
+                                     i32 num_samples)
+{
+    // Phases are computed in chunks as value + i * increment, which has no
+    // loop carried dependency and lets the compiler vectorise both loops.
+    real const increment = modulation::PhaseImpl::increment(phase);
+    std::array<mut_real, CHUNK_SIZE> phases;
+
+    // A project synced phase follows the transport. Every block starts at
+    // the phase of the project time and moves with the tempo within it.
+    if (phase.mode == modulation::Phase::SyncMode::ProjectSync)
+        modulation::PhaseImpl::advance(phase, value, 0);
+
+    mut_i32 offset = 0;
+    while (offset < num_samples)
+    {
+        i32 const count = std::min(CHUNK_SIZE, num_samples - offset);
+        for (mut_i32 i = 0; i < count; ++i)
+        {
+            real const p = value + static_cast<real>(i) * increment;
+            phases[i]    = p - floor_by_cast(p);
+        }
+
+        render(self, phases.data(), increment, out + offset, count);
+
+        real const next = value + static_cast<real>(count) * increment;
+        value           = next - floor_by_cast(next);
+        offset += count;
+    }
+}
+
+//-----------------------------------------------------------------------------
+} // namespace ha::dtb::synthesis
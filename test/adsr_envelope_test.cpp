@@ -1,8 +1,11 @@
 // Copyright René Hansen 2016.
 
 #include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#include "ha/dsp_tool_box/modulation/adsr_envelope_bank.h"
+#include "ha/dsp_tool_box/modulation/adsr_envelope_compact_bank.h"
 #include "gtest/gtest.h"
 #include <fstream>
+#include <vector>
 
 using namespace ha::dtb;
 using namespace ha::dtb::modulation;
@@ -169,3 +172,148 @@ TEST(ADSRTest, testReleaseInAttack)
     // "kReleaseInAttackData");
     trigger_envelope_test(kReleaseInAttackData);
 }
+
+//-----------------------------------------------------------------------------
+TEST(ADSRTest, testEnvelopeBankMatchesProcessor)
+{
+    static const float kFloatError = 0.00001f;
+    const TestData& data           = kOneFullCycleData;
+
+    adsr_envelope adsr;
+    adsr.set_att(data.att);
+    adsr.set_dec(data.dec);
+    adsr.set_sus(data.sus);
+    adsr.set_rel(data.rel);
+
+    // Voice 0 gets triggered, voice 1 stays silent.
+    adsr_envelope_bank bank(2);
+    bank.trigger(0);
+
+    float out[2] = {};
+    for (auto& timeValue : data.kTriggered)
+    {
+        const float times[2] = {timeValue.first, timeValue.first};
+        bank.read(adsr, times, out);
+        EXPECT_NEAR(timeValue.second, out[0], kFloatError);
+        EXPECT_EQ(0.f, out[1]);
+    }
+
+    bank.release(0);
+    for (auto& timeValue : data.kReleased)
+    {
+        const float times[2] = {timeValue.first, timeValue.first};
+        bank.read(adsr, times, out);
+        EXPECT_NEAR(timeValue.second, out[0], kFloatError);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(ADSRTest, testEnvelopeBankReadsStridedViews)
+{
+    adsr_envelope adsr;
+    adsr.set_att(1.f);
+    adsr.set_dec(1.f);
+    adsr.set_sus(0.5f);
+    adsr.set_rel(1.f);
+
+    adsr_envelope_bank bank(3);
+    adsr_envelope_bank expected_bank(3);
+    for (int voice = 0; voice < 2; ++voice)
+    {
+        bank.trigger(voice);
+        expected_bank.trigger(voice);
+    }
+
+    // Times and values are stored every other and every third sample.
+    const float times[6] = {0.5f, -1.f, 1.5f, -1.f, 0.25f, -1.f};
+    float out[9]         = {};
+    bank.read(adsr, core::BufferViewImpl::channel(times, 3, 2),
+              core::BufferViewImpl::channel(out, 3, 3));
+
+    const float expected_times[3] = {times[0], times[2], times[4]};
+    float expected[3]             = {};
+    expected_bank.read(adsr, expected_times, expected);
+    for (int voice = 0; voice < 3; ++voice)
+    {
+        EXPECT_EQ(expected[voice], out[voice * 3]);
+        EXPECT_EQ(0.f, out[voice * 3 + 1]);
+        EXPECT_EQ(0.f, out[voice * 3 + 2]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(ADSRTest, testCompactBankMatchesProcessor)
+{
+    static const float kFloatError = 0.0001f;
+    static const float kSampleRate = 1000.f;
+    static const int kBlockSize    = 16;
+
+    adsr_envelope_processor processor;
+    processor.set_att(0.1f);
+    processor.set_dec(0.2f);
+    processor.set_sus(0.5f);
+    processor.set_rel(0.3f);
+
+    adsr_envelope adsr;
+    adsr.set_att(0.1f);
+    adsr.set_dec(0.2f);
+    adsr.set_sus(0.5f);
+    adsr.set_rel(0.3f);
+
+    // Voice 0 gets triggered, voice 1 stays silent.
+    adsr_envelope_compact_bank bank(2);
+    bank.trigger(0);
+    processor.trigger();
+
+    float out[2]  = {};
+    int processed = 0;
+    for (int block = 0; block < 50; ++block)
+    {
+        if (block == 20)
+        {
+            bank.release(adsr, kSampleRate, 0);
+            processor.release();
+            processed = 0;
+        }
+
+        bank.read(adsr, kSampleRate, out);
+        const float time = static_cast<float>(processed) / kSampleRate;
+        EXPECT_NEAR(processor.read(time), out[0], kFloatError);
+        EXPECT_EQ(0.f, out[1]);
+
+        bank.advance(kBlockSize);
+        processed += kBlockSize;
+    }
+    EXPECT_EQ(0.f, out[0]);
+}
+
+//-----------------------------------------------------------------------------
+TEST(ADSRTest, testCompactBankReadsStridedView)
+{
+    static const float kSampleRate = 1000.f;
+    static const int kNumVoices    = 300;
+
+    adsr_envelope adsr;
+    adsr.set_att(0.1f);
+    adsr.set_dec(0.2f);
+    adsr.set_sus(0.5f);
+    adsr.set_rel(0.3f);
+
+    // More voices than one chunk, every other one triggered.
+    adsr_envelope_compact_bank bank(kNumVoices);
+    for (int voice = 0; voice < kNumVoices; voice += 2)
+        bank.trigger(voice);
+    bank.advance(50);
+
+    std::vector<float> expected(kNumVoices);
+    std::vector<float> out(kNumVoices * 2, -1.f);
+    bank.read(adsr, kSampleRate, expected.data());
+    bank.read(adsr, kSampleRate,
+              core::BufferViewImpl::channel(out.data(), kNumVoices, 2));
+    for (int voice = 0; voice < kNumVoices; ++voice)
+    {
+        EXPECT_EQ(expected[voice], out[voice * 2]);
+        EXPECT_EQ(-1.f, out[voice * 2 + 1]);
+    }
+    EXPECT_GT(expected[0], 0.f);
+}
@@ -0,0 +1,146 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/filtering/one_pole.h"
+#include "ha/dsp_tool_box/modulation/automation_lanes.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace ha::dtb;
+using namespace ha::dtb::modulation;
+
+/**
+ * @brief automation_lanes_test
+ */
+TEST(automation_lanes_test, test_ramps)
+{
+    constexpr int NUM_SAMPLES = 32;
+    AutomationLanes lanes     = AutomationLanesImpl::create(1, 4);
+    AutomationLanesImpl::set_value(lanes, 0, 0.f);
+    EXPECT_TRUE(AutomationLanesImpl::add_point(lanes, 0, 9, 1.f));
+    EXPECT_TRUE(AutomationLanesImpl::add_point(lanes, 0, 19, 0.5f));
+
+    std::vector<mut_real> out(NUM_SAMPLES);
+    AutomationLanesImpl::render(lanes, out.data(), NUM_SAMPLES);
+    for (int n = 0; n < 10; ++n)
+        EXPECT_FLOAT_EQ(out[n], static_cast<real>(n + 1) / 10.f);
+    for (int n = 10; n < 20; ++n)
+        EXPECT_FLOAT_EQ(out[n], 1.f - static_cast<real>(n - 9) / 20.f);
+    for (int n = 20; n < NUM_SAMPLES; ++n)
+        EXPECT_FLOAT_EQ(out[n], 0.5f);
+
+    // Points are consumed, the next block holds the last value.
+    AutomationLanesImpl::render(lanes, out.data(), NUM_SAMPLES);
+    for (int n = 0; n < NUM_SAMPLES; ++n)
+        EXPECT_FLOAT_EQ(out[n], 0.5f);
+}
+
+//-----------------------------------------------------------------------------
+TEST(automation_lanes_test, test_point_list_is_bounded)
+{
+    AutomationLanes lanes = AutomationLanesImpl::create(2, 2);
+    EXPECT_TRUE(AutomationLanesImpl::add_point(lanes, 1, 0, 1.f));
+    EXPECT_TRUE(AutomationLanesImpl::add_point(lanes, 1, 0, 0.25f));
+    EXPECT_FALSE(AutomationLanesImpl::add_point(lanes, 1, 3, 1.f));
+
+    std::vector<mut_real> out(2 * 8);
+    AutomationLanesImpl::render(lanes, out.data(), 8);
+    for (int n = 0; n < 8; ++n)
+    {
+        EXPECT_FLOAT_EQ(out[n], 0.f);
+        EXPECT_FLOAT_EQ(out[8 + n], 0.25f);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(automation_lanes_test, test_smoothing_matches_one_pole)
+{
+    constexpr int NUM_SAMPLES = 64;
+    constexpr real POLE       = 0.99f;
+    AutomationLanes lanes     = AutomationLanesImpl::create(1, 1);
+    AutomationLanesImpl::set_smoothing(lanes, 0, POLE);
+    AutomationLanesImpl::add_point(lanes, 0, 0, 1.f);
+
+    auto one_pole = filtering::OnePoleImpl::create(POLE);
+    std::vector<mut_real> out(NUM_SAMPLES);
+    for (int block = 0; block < 8; ++block)
+    {
+        AutomationLanesImpl::render(lanes, out.data(), NUM_SAMPLES);
+        for (int n = 0; n < NUM_SAMPLES; ++n)
+        {
+            real const expected =
+                filtering::OnePoleImpl::process(one_pole, 1.f);
+            EXPECT_FLOAT_EQ(out[n], expected);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(automation_lanes_test, test_smoothed_ramps_match_one_pole)
+{
+    constexpr int NUM_SAMPLES = 32;
+    constexpr real POLE       = 0.8f;
+    AutomationLanes lanes     = AutomationLanesImpl::create(2, 2);
+    AutomationLanesImpl::set_smoothing(lanes, 1, POLE);
+    for (int lane = 0; lane < 2; ++lane)
+    {
+        AutomationLanesImpl::add_point(lanes, lane, 7, 1.f);
+        AutomationLanesImpl::add_point(lanes, lane, 20, -0.5f);
+    }
+
+    // Lane 0 holds the plain ramps, lane 1 the same ramps smoothed.
+    std::vector<mut_real> out(2 * NUM_SAMPLES);
+    AutomationLanesImpl::render(lanes, out.data(), NUM_SAMPLES);
+    auto one_pole = filtering::OnePoleImpl::create(POLE);
+    filtering::OnePoleImpl::reset(one_pole, 0.f);
+    for (int n = 0; n < NUM_SAMPLES; ++n)
+    {
+        real const expected =
+            filtering::OnePoleImpl::process(one_pole, out[n]);
+        EXPECT_FLOAT_EQ(out[NUM_SAMPLES + n], expected);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(automation_lanes_test, test_many_lanes)
+{
+    constexpr int NUM_LANES   = 512;
+    constexpr int NUM_SAMPLES = 128;
+    AutomationLanes lanes     = AutomationLanesImpl::create(NUM_LANES, 8);
+    EXPECT_EQ(AutomationLanesImpl::size(lanes), NUM_LANES);
+    for (int lane = 0; lane < NUM_LANES; lane += 3)
+        AutomationLanesImpl::add_point(lanes, lane, lane % NUM_SAMPLES, 1.f);
+
+    std::vector<mut_real> out(NUM_LANES * NUM_SAMPLES);
+    AutomationLanesImpl::render(lanes, out.data(), NUM_SAMPLES);
+    for (int lane = 0; lane < NUM_LANES; ++lane)
+    {
+        real const expected = lane % 3 == 0 ? 1.f : 0.f;
+        EXPECT_FLOAT_EQ(out[(lane + 1) * NUM_SAMPLES - 1], expected);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(automation_lanes_test, test_settled_smoother_becomes_constant)
+{
+    constexpr int NUM_SAMPLES = 64;
+    AutomationLanes lanes     = AutomationLanesImpl::create(1, 1);
+    AutomationLanesImpl::set_smoothing(lanes, 0, 0.9f);
+    AutomationLanesImpl::add_point(lanes, 0, 0, 1.f);
+
+    std::vector<mut_real> out(NUM_SAMPLES);
+    auto const block =
+        core::BufferViewImpl::contiguous(out.data(), 1, NUM_SAMPLES);
+    core::BlockState state;
+    AutomationLanesImpl::render(lanes, block, &state);
+    EXPECT_FALSE(core::BlockStateImpl::is_constant(state));
+
+    // Without further points the smoother settles and the lane is skipped.
+    for (int i = 0; i < 16 && !core::BlockStateImpl::is_constant(state); ++i)
+        AutomationLanesImpl::render(lanes, block, &state);
+    EXPECT_TRUE(core::BlockStateImpl::is_constant(state));
+    EXPECT_FLOAT_EQ(state.value, 1.f);
+    for (int n = 0; n < NUM_SAMPLES; ++n)
+        EXPECT_FLOAT_EQ(out[n], 1.f);
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,171 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/core/block_state.h"
+#include "ha/dsp_tool_box/filtering/one_pole.h"
+#include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#include "ha/dsp_tool_box/modulation/modulation_phase.h"
+#include "ha/dsp_tool_box/modulation/mseg_envelope.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace ha::dtb;
+using namespace ha::dtb::core;
+
+namespace {
+
+//-----------------------------------------------------------------------------
+constexpr int NUM = 32;
+
+using Kind = BlockState::Kind;
+
+//-----------------------------------------------------------------------------
+ConstChannelView input_of(std::vector<mut_real> const& buffer)
+{
+    return BufferViewImpl::channel(buffer.data(),
+                                   static_cast<int>(buffer.size()));
+}
+
+//-----------------------------------------------------------------------------
+MutChannelView view_of(std::vector<mut_real>& buffer)
+{
+    return BufferViewImpl::channel(buffer.data(),
+                                   static_cast<int>(buffer.size()));
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+/**
+ * @brief block_state_test
+ */
+TEST(block_state_test, test_detect)
+{
+    std::vector<mut_real> buffer(NUM, 0.5f);
+    auto state = BlockStateImpl::detect(input_of(buffer));
+    EXPECT_EQ(state.kind, Kind::Constant);
+    EXPECT_FLOAT_EQ(state.value, 0.5f);
+
+    buffer[NUM - 1] = 0.f;
+    EXPECT_EQ(BlockStateImpl::detect(input_of(buffer)).kind, Kind::Dynamic);
+
+    std::vector<mut_real> silence(NUM, 0.f);
+    EXPECT_EQ(BlockStateImpl::detect(input_of(silence)).kind, Kind::Silent);
+    EXPECT_EQ(BlockStateImpl::constant(0.f).kind, Kind::Silent);
+}
+
+//-----------------------------------------------------------------------------
+TEST(block_state_test, test_multiply)
+{
+    std::vector<mut_real> in(NUM), gain(NUM, 0.5f), out(NUM);
+    for (int i = 0; i < NUM; ++i)
+        in[i] = static_cast<real>(i);
+
+    auto const dynamic = BlockStateImpl::dynamic();
+
+    auto state = BlockStateImpl::multiply(input_of(in), dynamic, input_of(gain),
+                                          BlockStateImpl::constant(0.5f),
+                                          view_of(out));
+    EXPECT_EQ(state.kind, Kind::Dynamic);
+    for (int i = 0; i < NUM; ++i)
+        EXPECT_FLOAT_EQ(out[i], in[i] * 0.5f);
+
+    state = BlockStateImpl::multiply(input_of(in), dynamic, input_of(gain),
+                                     BlockStateImpl::silent(), view_of(out));
+    EXPECT_EQ(state.kind, Kind::Silent);
+    EXPECT_EQ(out, std::vector<mut_real>(NUM, 0.f));
+
+    std::vector<mut_real> twos(NUM, 2.f);
+    state = BlockStateImpl::multiply(
+        input_of(twos), BlockStateImpl::constant(2.f), input_of(gain),
+        BlockStateImpl::constant(0.5f), view_of(out));
+    EXPECT_EQ(state.kind, Kind::Constant);
+    EXPECT_FLOAT_EQ(state.value, 1.f);
+    EXPECT_EQ(out, std::vector<mut_real>(NUM, 1.f));
+}
+
+//-----------------------------------------------------------------------------
+TEST(block_state_test, test_accumulate)
+{
+    std::vector<mut_real> sum(NUM, 0.f), mod(NUM, 1.f);
+    auto sum_state = BlockStateImpl::silent();
+
+    BlockStateImpl::accumulate(view_of(sum), sum_state, input_of(mod),
+                               BlockStateImpl::constant(1.f), 0.25f);
+    EXPECT_EQ(sum_state.kind, Kind::Constant);
+    EXPECT_FLOAT_EQ(sum_state.value, 0.25f);
+    EXPECT_EQ(sum, std::vector<mut_real>(NUM, 0.25f));
+
+    mod[3] = 3.f;
+    BlockStateImpl::accumulate(view_of(sum), sum_state, input_of(mod),
+                               BlockStateImpl::dynamic(), 0.5f);
+    EXPECT_EQ(sum_state.kind, Kind::Dynamic);
+    EXPECT_FLOAT_EQ(sum[0], 0.75f);
+    EXPECT_FLOAT_EQ(sum[3], 1.75f);
+}
+
+//-----------------------------------------------------------------------------
+TEST(block_state_test, test_envelope_producers)
+{
+    std::vector<mut_real> out(NUM);
+
+    modulation::adsr_envelope_processor adsr;
+    adsr.set_att(0.01f);
+    adsr.set_dec(0.01f);
+    adsr.set_sus(0.5f);
+    adsr.set_rel(0.01f);
+    EXPECT_EQ(adsr.read(0.f, 1000.f, view_of(out)).kind, Kind::Silent);
+    adsr.trigger();
+    EXPECT_EQ(adsr.read(0.f, 1000.f, view_of(out)).kind, Kind::Dynamic);
+    auto const sustain = adsr.read(1.f, 1000.f, view_of(out));
+    EXPECT_EQ(sustain.kind, Kind::Constant);
+    EXPECT_FLOAT_EQ(sustain.value, 0.5f);
+    EXPECT_EQ(out, std::vector<mut_real>(NUM, 0.5f));
+
+    auto const mseg =
+        modulation::MsegImpl::create_adsr(0.01f, 0.01f, 0.5f, 0.01f, 1000.f);
+    modulation::MsegVoice voice;
+    EXPECT_EQ(modulation::MsegImpl::render(mseg, voice, view_of(out)).kind,
+              Kind::Silent);
+    modulation::MsegImpl::trigger(mseg, voice);
+    EXPECT_EQ(modulation::MsegImpl::render(mseg, voice, view_of(out)).kind,
+              Kind::Dynamic);
+    auto const held = modulation::MsegImpl::render(mseg, voice, view_of(out));
+    EXPECT_EQ(held.kind, Kind::Constant);
+    EXPECT_FLOAT_EQ(held.value, 0.5f);
+}
+
+//-----------------------------------------------------------------------------
+TEST(block_state_test, test_smoother_and_phase)
+{
+    std::vector<mut_real> in(NUM, 1.f), out(NUM);
+
+    auto one_pole = filtering::OnePoleImpl::create(0.5f);
+    auto state    = filtering::OnePoleImpl::process(
+        one_pole, input_of(in), BlockStateImpl::constant(1.f), view_of(out));
+    EXPECT_EQ(state.kind, Kind::Dynamic);
+    EXPECT_FLOAT_EQ(out[0], 0.5f);
+
+    filtering::OnePoleImpl::reset(one_pole, 1.f);
+    state = filtering::OnePoleImpl::process(one_pole, input_of(in),
+                                            view_of(out));
+    EXPECT_EQ(state.kind, Kind::Constant);
+    EXPECT_FLOAT_EQ(state.value, 1.f);
+
+    auto phase = modulation::PhaseImpl::create();
+    modulation::PhaseImpl::set_sync_mode(phase,
+                                         modulation::Phase::SyncMode::Free);
+    modulation::PhaseImpl::set_rate(phase, 0.f);
+    mut_real value = 0.25f;
+    BlockState phase_state;
+    modulation::PhaseImpl::advance(phase, value, view_of(out), phase_state);
+    EXPECT_EQ(phase_state.kind, Kind::Constant);
+    EXPECT_FLOAT_EQ(phase_state.value, 0.25f);
+
+    // A phase of 1 is written as 0, the state must report the same.
+    value = 1.f;
+    modulation::PhaseImpl::advance(phase, value, view_of(out), phase_state);
+    EXPECT_EQ(phase_state.kind, Kind::Silent);
+    EXPECT_FLOAT_EQ(out[0], 0.f);
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,192 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/core/buffer_view.h"
+#include "ha/dsp_tool_box/filtering/one_pole.h"
+#include "ha/dsp_tool_box/filtering/one_pole_bank.h"
+#include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#include "ha/dsp_tool_box/modulation/modulation_phase.h"
+#include "ha/dsp_tool_box/modulation/mseg_envelope.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace ha::dtb;
+using namespace ha::dtb::core;
+
+namespace {
+
+//-----------------------------------------------------------------------------
+std::vector<mut_real> make_ramp(int num)
+{
+    std::vector<mut_real> ramp(static_cast<size_t>(num));
+    for (int i = 0; i < num; ++i)
+        ramp[i] = static_cast<real>(i % 7) / 7.f;
+    return ramp;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+/**
+ * @brief buffer_view_test
+ */
+TEST(buffer_view_test, test_alignment)
+{
+    alignas(64) mut_real buffer[64] = {};
+    EXPECT_EQ(BufferViewImpl::alignment_of(buffer), 64u);
+    EXPECT_EQ(BufferViewImpl::alignment_of(buffer + 1), 4u);
+    EXPECT_EQ(BufferViewImpl::alignment_of(buffer + 4), 16u);
+
+    auto const view = BufferViewImpl::channel(buffer, 64);
+    EXPECT_TRUE(BufferViewImpl::is_aligned(view, 64));
+    auto const sub = BufferViewImpl::sub_range(view, 8, 16);
+    EXPECT_EQ(sub.data, buffer + 8);
+    EXPECT_EQ(sub.alignment, 32u);
+    EXPECT_FALSE(BufferViewImpl::is_aligned(sub, 64));
+
+    auto const block = BufferViewImpl::contiguous(buffer, 4, 16);
+    EXPECT_EQ(block.alignment, 64u);
+    EXPECT_EQ(BufferViewImpl::sub_range(block, 4, 8).alignment, 16u);
+    EXPECT_EQ(BufferViewImpl::interleaved(buffer, 2, 32).alignment, 4u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(buffer_view_test, test_channels)
+{
+    std::vector<mut_real> frames(3 * 8);
+    for (size_t i = 0; i < frames.size(); ++i)
+        frames[i] = static_cast<real>(i);
+
+    auto const interleaved = BufferViewImpl::interleaved(frames.data(), 3, 8);
+    EXPECT_TRUE(BufferViewImpl::is_interleaved(interleaved));
+    auto const second = BufferViewImpl::channel(interleaved, 1);
+    EXPECT_EQ(second.stride, 3);
+    EXPECT_FLOAT_EQ(BufferViewImpl::at(second, 2), 7.f);
+
+    auto const sub = BufferViewImpl::sub_range(interleaved, 2, 4);
+    EXPECT_FLOAT_EQ(BufferViewImpl::channel(sub, 0).data[0], 6.f);
+    EXPECT_EQ(BufferViewImpl::frames(sub), frames.data() + 6);
+
+    mut_real* channels[] = {frames.data() + 8, frames.data()};
+    auto const planar    = BufferViewImpl::planar(channels, 2, 8);
+    EXPECT_FALSE(BufferViewImpl::is_interleaved(planar));
+    EXPECT_FLOAT_EQ(BufferViewImpl::channel(planar, 0).data[0], 8.f);
+    auto const tail = BufferViewImpl::sub_range(planar, 5, 3);
+    EXPECT_FLOAT_EQ(BufferViewImpl::channel(tail, 1).data[0], 5.f);
+}
+
+//-----------------------------------------------------------------------------
+TEST(buffer_view_test, test_one_pole_strided_and_in_place)
+{
+    constexpr int NUM = 32;
+    auto const in     = make_ramp(NUM);
+
+    auto reference = filtering::OnePoleImpl::create(0.8f);
+    std::vector<mut_real> expected(NUM);
+    for (int i = 0; i < NUM; ++i)
+        expected[i] = filtering::OnePoleImpl::process(reference, in[i]);
+
+    // Write into the right channel of a stereo buffer.
+    auto one_pole = filtering::OnePoleImpl::create(0.8f);
+    std::vector<mut_real> stereo(2 * NUM, -1.f);
+    auto const block = BufferViewImpl::interleaved(stereo.data(), 2, NUM);
+    filtering::OnePoleImpl::process(one_pole,
+                                    BufferViewImpl::channel(in.data(), NUM),
+                                    BufferViewImpl::channel(block, 1));
+    for (int i = 0; i < NUM; ++i)
+    {
+        EXPECT_FLOAT_EQ(stereo[2 * i], -1.f);
+        EXPECT_FLOAT_EQ(stereo[2 * i + 1], expected[i]);
+    }
+
+    auto in_place = filtering::OnePoleImpl::create(0.8f);
+    std::vector<mut_real> buffer(in);
+    filtering::OnePoleImpl::process(
+        in_place, BufferViewImpl::channel(buffer.data(), NUM));
+    EXPECT_EQ(buffer, expected);
+}
+
+//-----------------------------------------------------------------------------
+TEST(buffer_view_test, test_one_pole_bank_layouts)
+{
+    constexpr int NUM_FILTERS = 5;
+    constexpr int NUM_SAMPLES = 16;
+    auto const frames         = make_ramp(NUM_FILTERS * NUM_SAMPLES);
+
+    auto interleaved_bank = filtering::OnePoleBankImpl::create(NUM_FILTERS);
+    std::vector<mut_real> expected(frames.size());
+    filtering::OnePoleBankImpl::process(
+        interleaved_bank,
+        BufferViewImpl::interleaved(frames.data(), NUM_FILTERS, NUM_SAMPLES),
+        BufferViewImpl::interleaved(expected.data(), NUM_FILTERS,
+                                    NUM_SAMPLES));
+
+    // Same input, written channel after channel.
+    auto planar_bank = filtering::OnePoleBankImpl::create(NUM_FILTERS);
+    std::vector<mut_real> actual(frames.size());
+    filtering::OnePoleBankImpl::process(
+        planar_bank,
+        BufferViewImpl::interleaved(frames.data(), NUM_FILTERS, NUM_SAMPLES),
+        BufferViewImpl::contiguous(actual.data(), NUM_FILTERS, NUM_SAMPLES));
+
+    for (int f = 0; f < NUM_FILTERS; ++f)
+    {
+        for (int i = 0; i < NUM_SAMPLES; ++i)
+            EXPECT_FLOAT_EQ(actual[f * NUM_SAMPLES + i],
+                            expected[i * NUM_FILTERS + f]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(buffer_view_test, test_phase_block)
+{
+    constexpr int NUM = 100;
+    auto phase        = modulation::PhaseImpl::create();
+    modulation::PhaseImpl::set_sync_mode(phase,
+                                         modulation::Phase::SyncMode::Free);
+    modulation::PhaseImpl::set_sample_rate(phase, 1000.f);
+    modulation::PhaseImpl::set_rate(phase, 25.f);
+
+    mut_real value = 0.f;
+    std::vector<mut_real> out(NUM);
+    bool const overflow = modulation::PhaseImpl::advance(
+        phase, value, BufferViewImpl::channel(out.data(), NUM));
+    EXPECT_TRUE(overflow);
+    EXPECT_FLOAT_EQ(out[0], 0.f);
+    EXPECT_NEAR(out[20], 0.5f, 1e-5);
+    EXPECT_NEAR(out[41], 0.025f, 1e-5);
+    EXPECT_NEAR(value, 0.5f, 1e-5);
+}
+
+//-----------------------------------------------------------------------------
+TEST(buffer_view_test, test_envelopes_into_views)
+{
+    constexpr int NUM          = 256;
+    constexpr real SAMPLE_RATE = 1000.f;
+
+    modulation::adsr_envelope_processor adsr;
+    adsr.set_att(0.1f);
+    adsr.set_dec(0.1f);
+    adsr.set_sus(0.5f);
+    adsr.set_rel(0.1f);
+    adsr.trigger();
+    std::vector<mut_real> expected(NUM);
+    adsr.read(0.f, SAMPLE_RATE, BufferViewImpl::channel(expected.data(), NUM));
+
+    auto const mseg = modulation::MsegImpl::create_adsr(0.1f, 0.1f, 0.5f, 0.1f,
+                                                        SAMPLE_RATE);
+
+    auto bank = modulation::MsegBankImpl::create(2);
+    modulation::MsegBankImpl::trigger(mseg, bank, 0);
+    modulation::MsegBankImpl::trigger(mseg, bank, 1);
+    std::vector<mut_real> frames(2 * NUM);
+    modulation::MsegBankImpl::render(
+        mseg, bank, BufferViewImpl::interleaved(frames.data(), 2, NUM));
+
+    for (int i = 0; i < NUM; ++i)
+    {
+        EXPECT_NEAR(frames[2 * i], expected[i], 1e-5);
+        EXPECT_FLOAT_EQ(frames[2 * i + 1], frames[2 * i]);
+    }
+}
+
+//-----------------------------------------------------------------------------
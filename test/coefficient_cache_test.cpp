@@ -0,0 +1,145 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/core/coefficient_cache.h"
+#include "ha/dsp_tool_box/filtering/one_pole.h"
+#include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <memory>
+
+using namespace ha::dtb;
+
+/**
+ * @brief coefficient_cache_test
+ */
+TEST(coefficient_cache_test, test_intern_shares_records)
+{
+    core::CoefficientCache<int, float> cache;
+    auto make          = [](int key) { return float(key) * 2.f; };
+    auto rec_0         = cache.intern(1, make);
+    auto rec_1         = cache.intern(1, make);
+    auto rec_2         = cache.intern(2, make);
+    auto const address = reinterpret_cast<std::uintptr_t>(rec_0.get());
+
+    EXPECT_EQ(rec_0.get(), rec_1.get());
+    EXPECT_NE(rec_0.get(), rec_2.get());
+    EXPECT_EQ(*rec_2, 4.f);
+    EXPECT_EQ(address % 64, 0u);
+    EXPECT_EQ(cache.size(), 2u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(coefficient_cache_test, test_collect_releases_unused_records)
+{
+    core::CoefficientCache<int, float> cache;
+    auto make  = [](int key) { return float(key); };
+    auto rec_0 = cache.intern(1, make);
+    cache.intern(2, make);
+
+    EXPECT_EQ(cache.collect(), 1u);
+    EXPECT_EQ(cache.size(), 1u);
+    rec_0.reset();
+    EXPECT_EQ(cache.collect(), 1u);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(coefficient_cache_test, test_slot_swap)
+{
+    core::CoefficientCache<int, float> cache;
+    auto make = [](int key) { return float(key); };
+
+    core::CoefficientSlot<float> slot(cache.intern(1, make));
+    EXPECT_EQ(*slot.load(), 1.f);
+    slot.store(cache.intern(2, make));
+    EXPECT_EQ(*slot.load(), 2.f);
+
+    // The first record is retired until the realtime thread acknowledges.
+    EXPECT_EQ(cache.collect(), 0u);
+    slot.acknowledge();
+    EXPECT_EQ(slot.reclaim(), 0u);
+    EXPECT_EQ(cache.collect(), 1u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(coefficient_cache_test, test_slot_keeps_loaded_record_alive)
+{
+    core::CoefficientCache<int, float> cache;
+    auto make = [](int key) { return float(key); };
+
+    core::CoefficientSlot<float> slot(cache.intern(1, make));
+    std::weak_ptr<float const> interned = cache.intern(1, make);
+    slot.acknowledge();
+    float const* loaded = slot.load();
+
+    // The realtime thread still reads loaded during the swap and collect.
+    slot.store(cache.intern(2, make));
+    EXPECT_EQ(cache.collect(), 0u);
+    EXPECT_FALSE(interned.expired());
+    EXPECT_EQ(*loaded, 1.f);
+
+    // A record which was never interned is retired the same way.
+    auto unshared = std::make_shared<float const>(3.f);
+    std::weak_ptr<float const> unshared_ref = unshared;
+    slot.store(std::move(unshared));
+    slot.store(cache.intern(4, make));
+    EXPECT_FALSE(unshared_ref.expired());
+    EXPECT_EQ(slot.reclaim(), 3u);
+
+    slot.acknowledge();
+    EXPECT_EQ(*slot.load(), 4.f);
+    EXPECT_EQ(slot.reclaim(), 0u);
+    EXPECT_TRUE(unshared_ref.expired());
+    EXPECT_EQ(cache.collect(), 2u);
+    EXPECT_TRUE(interned.expired());
+}
+
+//-----------------------------------------------------------------------------
+TEST(coefficient_cache_test, test_one_pole_shared_coefficients)
+{
+    auto coeffs_0 = filtering::OnePoleImpl::intern(0.1f, 44100.f);
+    auto coeffs_1 = filtering::OnePoleImpl::intern(0.1f, 44100.f);
+    EXPECT_EQ(coeffs_0.get(), coeffs_1.get());
+
+    real const a  = filtering::OnePoleImpl::tau_to_pole(0.1f, 44100.f);
+    auto one_pole = filtering::OnePoleImpl::create(a);
+    mut_real z    = 0.f;
+    for (int i = 0; i < 64; ++i)
+    {
+        EXPECT_EQ(filtering::OnePoleImpl::process(one_pole, 1.f),
+                  filtering::OnePoleImpl::process(*coeffs_0, z, 1.f));
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(coefficient_cache_test, test_adsr_voice_matches_processor)
+{
+    using namespace modulation;
+    auto shared = adsr_envelope::intern(1.f, 2.f, 0.5f, 2.f);
+    EXPECT_EQ(shared.get(), adsr_envelope::intern(1.f, 2.f, 0.5f, 2.f).get());
+
+    adsr_envelope_processor processor;
+    processor.set_att(1.f);
+    processor.set_dec(2.f);
+    processor.set_sus(0.5f);
+    processor.set_rel(2.f);
+
+    adsr_envelope_voice voice;
+    processor.trigger();
+    voice.trigger();
+    for (int i = 0; i < 40; ++i)
+    {
+        real const time = static_cast<real>(i) * 0.1f;
+        EXPECT_EQ(processor.read(time), voice.read(*shared, time));
+    }
+
+    processor.release();
+    voice.release();
+    for (int i = 0; i < 20; ++i)
+    {
+        real const time = static_cast<real>(i) * 0.1f;
+        EXPECT_EQ(processor.read(time), voice.read(*shared, time));
+    }
+}
+
+//-----------------------------------------------------------------------------
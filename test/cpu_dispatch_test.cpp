@@ -0,0 +1,117 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/core/cpu_dispatch.h"
+#include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace ha::dtb;
+using namespace ha::dtb::core;
+
+namespace {
+
+//-----------------------------------------------------------------------------
+std::vector<Isa> supported_isas()
+{
+    std::vector<Isa> isas;
+    for (int i = 0; i < static_cast<int>(Isa::Count); ++i)
+    {
+        if (CpuDispatchImpl::is_supported(static_cast<Isa>(i)))
+            isas.push_back(static_cast<Isa>(i));
+    }
+    return isas;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+/**
+ * @brief cpu_dispatch_test
+ */
+TEST(cpu_dispatch_test, test_scalar_is_always_supported)
+{
+    EXPECT_TRUE(CpuDispatchImpl::is_supported(Isa::Scalar));
+    Isa const best = CpuDispatchImpl::best_supported();
+    EXPECT_TRUE(CpuDispatchImpl::is_supported(best));
+}
+
+//-----------------------------------------------------------------------------
+TEST(cpu_dispatch_test, test_force)
+{
+    Isa const previous = CpuDispatchImpl::active();
+    for (Isa isa : supported_isas())
+    {
+        EXPECT_TRUE(CpuDispatchImpl::force(isa));
+        EXPECT_EQ(CpuDispatchImpl::active(), isa);
+        EXPECT_EQ(&CpuDispatchImpl::kernels(), &CpuDispatchImpl::kernels(isa));
+    }
+    EXPECT_FALSE(CpuDispatchImpl::force(Isa::Count));
+    CpuDispatchImpl::force(previous);
+}
+
+//-----------------------------------------------------------------------------
+TEST(cpu_dispatch_test, test_isa_names)
+{
+    Isa isa = Isa::Scalar;
+    EXPECT_TRUE(CpuDispatchImpl::from_string("avx2", isa));
+    EXPECT_EQ(isa, Isa::AVX2);
+    EXPECT_STREQ(CpuDispatchImpl::to_string(Isa::NEON), "neon");
+    EXPECT_FALSE(CpuDispatchImpl::from_string("mmx", isa));
+}
+
+//-----------------------------------------------------------------------------
+TEST(cpu_dispatch_test, test_kernels_match_scalar)
+{
+    constexpr int NUM = 37;
+    std::vector<mut_real> in(NUM), a(NUM), b(NUM), increments(NUM);
+    for (int i = 0; i < NUM; ++i)
+    {
+        in[i]         = static_cast<real>(i) / (NUM - 1);
+        a[i]          = 0.9f;
+        b[i]          = 0.1f;
+        increments[i] = 0.001f * static_cast<real>(i);
+    }
+
+    auto const& scalar = CpuDispatchImpl::kernels(Isa::Scalar);
+    for (Isa isa : supported_isas())
+    {
+        auto const& kernels = CpuDispatchImpl::kernels(isa);
+
+        std::vector<mut_real> expected(NUM), actual(NUM);
+        scalar.ease_virus_ti(in.data(), expected.data(), NUM);
+        kernels.ease_virus_ti(in.data(), actual.data(), NUM);
+        for (int i = 0; i < NUM; ++i)
+        {
+            EXPECT_NEAR(actual[i], expected[i], 1e-6);
+            EXPECT_NEAR(expected[i],
+                        modulation::easing::ease_virus_ti<real>(in[i]), 0.f);
+        }
+
+        std::vector<mut_real> z_0(NUM, 0.5f), z_1(NUM, 0.5f);
+        scalar.one_pole_step(a.data(), b.data(), z_0.data(), in.data(),
+                             expected.data(), NUM);
+        kernels.one_pole_step(a.data(), b.data(), z_1.data(), in.data(),
+                              actual.data(), NUM);
+        EXPECT_EQ(expected, actual);
+
+        std::vector<mut_real> phases_0(in), phases_1(in);
+        std::vector<mut_u8> overflows_0(NUM), overflows_1(NUM);
+        scalar.advance_phases(phases_0.data(), increments.data(),
+                              overflows_0.data(), 100, NUM);
+        kernels.advance_phases(phases_1.data(), increments.data(),
+                               overflows_1.data(), 100, NUM);
+        EXPECT_EQ(phases_0, phases_1);
+        EXPECT_EQ(overflows_0, overflows_1);
+
+        constexpr int NUM_TAPS = 7;
+        std::vector<mut_real> taps(b.begin(), b.begin() + NUM_TAPS);
+        taps[3] = 0.5f;
+        scalar.fir(in.data(), taps.data(), expected.data(), NUM_TAPS,
+                   NUM - NUM_TAPS + 1);
+        kernels.fir(in.data(), taps.data(), actual.data(), NUM_TAPS,
+                    NUM - NUM_TAPS + 1);
+        EXPECT_EQ(expected, actual);
+    }
+}
+
+//-----------------------------------------------------------------------------
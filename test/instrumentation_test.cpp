@@ -0,0 +1,157 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/core/instrumentation.h"
+#include "ha/dsp_tool_box/filtering/one_pole.h"
+#include "ha/dsp_tool_box/filtering/one_pole_bank.h"
+#include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#include "ha/dsp_tool_box/modulation/adsr_envelope_bank.h"
+#include "ha/dsp_tool_box/modulation/modulation_phase.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace ha::dtb;
+using namespace ha::dtb::core;
+
+/**
+ * @brief instrumentation_test
+ */
+TEST(instrumentation_test, test_ring_buffer_push_pop)
+{
+    SpscRingBuffer<int, 4> ring;
+    EXPECT_TRUE(ring.try_push(1));
+    EXPECT_TRUE(ring.try_push(2));
+    EXPECT_EQ(ring.size(), 2u);
+
+    int value = 0;
+    EXPECT_TRUE(ring.try_pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(ring.try_pop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(ring.try_pop(value));
+}
+
+//-----------------------------------------------------------------------------
+TEST(instrumentation_test, test_ring_buffer_full)
+{
+    SpscRingBuffer<int, 2> ring;
+    EXPECT_TRUE(ring.try_push(1));
+    EXPECT_TRUE(ring.try_push(2));
+    EXPECT_FALSE(ring.try_push(3));
+}
+
+//-----------------------------------------------------------------------------
+TEST(instrumentation_test, test_block_reports_are_published)
+{
+    Profiler profiler;
+    InstrumentationImpl::begin_block(profiler);
+    EXPECT_EQ(InstrumentationImpl::active_report(), &profiler.current);
+    InstrumentationImpl::end_block(profiler);
+    EXPECT_EQ(InstrumentationImpl::active_report(), nullptr);
+
+    InstrumentationImpl::begin_block(profiler);
+    InstrumentationImpl::end_block(profiler);
+
+    BlockReport report;
+    EXPECT_TRUE(InstrumentationImpl::try_pop(profiler, report));
+    EXPECT_EQ(report.block_index, 0u);
+    EXPECT_TRUE(InstrumentationImpl::try_pop(profiler, report));
+    EXPECT_EQ(report.block_index, 1u);
+    EXPECT_FALSE(InstrumentationImpl::try_pop(profiler, report));
+}
+
+//-----------------------------------------------------------------------------
+TEST(instrumentation_test, test_primitive_counters)
+{
+    Profiler profiler;
+    InstrumentationImpl::begin_block(profiler);
+
+    auto one_pole = filtering::OnePoleImpl::create();
+    filtering::OnePoleImpl::process(one_pole, 1.f);
+    filtering::OnePoleImpl::reset(one_pole, 1.f);
+    filtering::OnePoleImpl::process(one_pole, 1.f);
+
+    auto val   = real(0.);
+    auto phase = modulation::PhaseImpl::create();
+    modulation::PhaseImpl::set_note_len(phase, 1.f);
+    modulation::PhaseImpl::advance(phase, val, 44100 * 2);
+
+    modulation::adsr_envelope_processor adsr;
+    adsr.set_att(1.f);
+    adsr.trigger();
+    adsr.read(0.5f);
+
+    InstrumentationImpl::end_block(profiler);
+
+    BlockReport report;
+    ASSERT_TRUE(InstrumentationImpl::try_pop(profiler, report));
+#if HA_DTB_ENABLE_INSTRUMENTATION
+    EXPECT_EQ(report.calls[static_cast<std::size_t>(Probe::OnePole)], 2u);
+    EXPECT_EQ(report.one_pole_active, 1u);
+    EXPECT_EQ(report.one_pole_settled, 1u);
+    EXPECT_EQ(report.phase_overflows, 1u);
+    using stages            = modulation::adsr_envelope::stages;
+    auto const attack_index = static_cast<std::size_t>(stages::STAGE_ATTACK);
+    EXPECT_EQ(report.adsr_stage_voices[attack_index], 1u);
+#else
+    EXPECT_EQ(report.calls[static_cast<std::size_t>(Probe::OnePole)], 0u);
+    EXPECT_EQ(report.phase_overflows, 0u);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+TEST(instrumentation_test, test_bank_and_block_counters)
+{
+    constexpr int NUM_SAMPLES = 16;
+    Profiler profiler;
+    InstrumentationImpl::begin_block(profiler);
+
+    // Filter 0 already sits at its input, the other two move.
+    auto bank = filtering::OnePoleBankImpl::create(3);
+    filtering::OnePoleBankImpl::reset(bank, 0, 1.f);
+    std::vector<mut_real> frames(3 * NUM_SAMPLES, 1.f);
+    filtering::OnePoleBankImpl::process(bank, frames.data(), frames.data(),
+                                        NUM_SAMPLES);
+
+    std::vector<mut_real> in(NUM_SAMPLES, 1.f), out(NUM_SAMPLES);
+    filtering::OnePoleBankImpl::process_filter(bank, 0, in.data(), out.data(),
+                                               NUM_SAMPLES);
+    auto const in_view  = BufferViewImpl::channel(in.data(), NUM_SAMPLES);
+    auto const out_view = BufferViewImpl::channel(out.data(), NUM_SAMPLES);
+    auto one_pole       = filtering::OnePoleImpl::create();
+    filtering::OnePoleImpl::process(one_pole, BufferViewImpl::as_const(in_view),
+                                    out_view);
+
+    // Two of four voices attack. The block read counts its voice once.
+    modulation::adsr_envelope adsr;
+    adsr.set_att(1.f);
+    modulation::adsr_envelope_bank voices(4);
+    voices.trigger(0);
+    voices.trigger(1);
+    float const times[4] = {0.5f, 0.5f, 0.5f, 0.5f};
+    float values[4]      = {};
+    voices.read(adsr, times, values);
+
+    modulation::adsr_envelope_voice voice;
+    voice.trigger();
+    voice.read(adsr, 0.f, 1000.f, out_view);
+
+    InstrumentationImpl::end_block(profiler);
+
+    BlockReport report;
+    ASSERT_TRUE(InstrumentationImpl::try_pop(profiler, report));
+#if HA_DTB_ENABLE_INSTRUMENTATION
+    EXPECT_EQ(report.one_pole_settled, 2u);
+    EXPECT_EQ(report.one_pole_active, 3u);
+    using stages = modulation::adsr_envelope::stages;
+    auto const before_index =
+        static_cast<std::size_t>(stages::STAGE_BEFORE_TRIGGER);
+    auto const attack_index = static_cast<std::size_t>(stages::STAGE_ATTACK);
+    EXPECT_EQ(report.adsr_stage_voices[before_index], 2u);
+    EXPECT_EQ(report.adsr_stage_voices[attack_index], 3u);
+#else
+    EXPECT_EQ(report.one_pole_settled, 0u);
+    EXPECT_EQ(report.adsr_stage_voices[0], 0u);
+#endif
+}
+
+//-----------------------------------------------------------------------------
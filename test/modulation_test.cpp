@@ -1,6 +1,8 @@
 // Copyright(c) 2021 Hansen Audio.
 
+#include "ha/dsp_tool_box/modulation/compact_phase_bank.h"
 #include "ha/dsp_tool_box/modulation/modulation_phase.h"
+#include "ha/dsp_tool_box/modulation/phase_bank.h"
 #include "gtest/gtest.h"
 
 using real = ha::dtb::real;
@@ -105,4 +107,96 @@ TEST(modulation_phase_test, test_floor_by_cast_2)
     real val0               = 3.75;
     real val0_floor_by_cast = static_cast<real>(static_cast<i32>(val0));
     EXPECT_EQ(val0_floor_by_cast, 3.0);
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------------------
+TEST(modulation_phase_test, test_phase_bank_matches_phase)
+{
+    auto phase = PhaseImpl::create();
+    auto bank  = PhaseBankImpl::create(3);
+    PhaseBankImpl::set_phase(bank, 0, phase);
+    PhaseBankImpl::set_phase(bank, 1, phase);
+    PhaseBankImpl::set_value(bank, 1, 0.5f);
+    PhaseBankImpl::set_increment(bank, 2, 0.f);
+
+    auto val_0 = real(0.);
+    auto val_1 = real(0.5);
+    for (int block = 0; block < 100; ++block)
+    {
+        PhaseBankImpl::advance(bank, 128);
+        bool const overflow_0 = PhaseImpl::advance(phase, val_0, 128);
+        bool const overflow_1 = PhaseImpl::advance(phase, val_1, 128);
+
+        EXPECT_EQ(bank.values[0], val_0);
+        EXPECT_EQ(bank.values[1], val_1);
+        EXPECT_EQ(bank.values[2], 0.f);
+        EXPECT_EQ(bank.overflows[0] == 1, overflow_0);
+        EXPECT_EQ(bank.overflows[1] == 1, overflow_1);
+    }
+}
+
+//------------------------------------------------------------------------
+TEST(modulation_phase_test, test_compact_phase_bank_follows_phase)
+{
+    auto phase = PhaseImpl::create();
+    auto bank  = CompactPhaseBankImpl::create(3, 2);
+    CompactPhaseBankImpl::set_group_phase(bank, 0, phase);
+    CompactPhaseBankImpl::set_group(bank, 1, 0);
+    CompactPhaseBankImpl::set_value(bank, 1, 0.5f);
+    CompactPhaseBankImpl::set_group(bank, 2, 1);
+
+    // A double reference, the float phase itself drifts over 1000 blocks.
+    double const increment = PhaseImpl::increment(phase);
+    double expected        = 0.;
+    for (int block = 0; block < 1000; ++block)
+    {
+        CompactPhaseBankImpl::advance(bank, 128);
+        expected += increment * 128.;
+        bool const overflow = expected >= 1.;
+        expected -= static_cast<double>(static_cast<int>(expected));
+
+        double const value = CompactPhaseBankImpl::value(bank, 0);
+        EXPECT_NEAR(value, expected, 1. / 65536.);
+        auto const half = static_cast<ha::dtb::mut_u16>(bank.values[0] + 32768);
+        EXPECT_EQ(bank.values[1], half);
+        EXPECT_EQ(bank.values[2], 0);
+        if (value > 0.001 && value < 0.999)
+        {
+            EXPECT_EQ(bank.overflows[0] == 1, overflow);
+        }
+    }
+}
+
+//------------------------------------------------------------------------
+TEST(modulation_phase_test, test_compact_phase_bank_round_trip)
+{
+    auto bank = CompactPhaseBankImpl::create(1);
+    for (int step = 0; step < 65536; step += 257)
+    {
+        real const value = static_cast<real>(step) / 65536.f;
+        CompactPhaseBankImpl::set_value(bank, 0, value);
+        EXPECT_EQ(CompactPhaseBankImpl::value(bank, 0), value);
+        EXPECT_EQ(bank.values[0], step);
+    }
+
+    CompactPhaseBankImpl::set_value(bank, 0, 0.3f);
+    EXPECT_NEAR(CompactPhaseBankImpl::value(bank, 0), 0.3f, 1.f / 131072.f);
+}
+
+//-----------------------------------------------------------------------------
+TEST(modulation_phase_test, test_compact_phase_bank_reads_strided_view)
+{
+    auto bank = CompactPhaseBankImpl::create(3);
+    CompactPhaseBankImpl::set_value(bank, 0, 0.25f);
+    CompactPhaseBankImpl::set_value(bank, 1, 0.5f);
+    CompactPhaseBankImpl::set_value(bank, 2, 0.75f);
+
+    float out[6] = {-1.f, -1.f, -1.f, -1.f, -1.f, -1.f};
+    CompactPhaseBankImpl::read(
+        bank, ha::dtb::core::BufferViewImpl::channel(out, 3, 2));
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(out[i * 2], CompactPhaseBankImpl::value(bank, i));
+        EXPECT_EQ(out[i * 2 + 1], -1.f);
+    }
+}
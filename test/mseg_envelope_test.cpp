@@ -0,0 +1,171 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#include "ha/dsp_tool_box/modulation/mseg_envelope.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <vector>
+
+using namespace ha::dtb;
+using namespace ha::dtb::modulation;
+
+namespace {
+
+//-----------------------------------------------------------------------------
+constexpr real SAMPLE_RATE = 48000.f;
+constexpr int BLOCK_SIZE   = 64;
+
+//-----------------------------------------------------------------------------
+std::vector<mut_real> render_mseg(Mseg const& mseg,
+                                  int num_samples,
+                                  int release_sample,
+                                  int block_size)
+{
+    std::vector<mut_real> out(static_cast<size_t>(num_samples));
+    MsegVoice voice;
+    MsegImpl::trigger(mseg, voice);
+    for (int n = 0; n < num_samples; n += block_size)
+    {
+        if (n == release_sample)
+            MsegImpl::release(mseg, voice);
+
+        int const num = std::min(block_size, num_samples - n);
+        MsegImpl::render(mseg, voice, out.data() + n, num);
+    }
+    return out;
+}
+
+//-----------------------------------------------------------------------------
+void testMsegMatchesAdsr(real att, real dec, real sus, real rel)
+{
+    constexpr int RELEASE_SAMPLE = 64 * 1500;
+    constexpr int NUM_SAMPLES    = RELEASE_SAMPLE * 2;
+
+    Mseg const mseg = MsegImpl::create_adsr(att, dec, sus, rel, SAMPLE_RATE);
+    auto const out =
+        render_mseg(mseg, NUM_SAMPLES, RELEASE_SAMPLE, BLOCK_SIZE);
+
+    adsr_envelope_processor adsr;
+    adsr.set_att(att);
+    adsr.set_dec(dec);
+    adsr.set_sus(sus);
+    adsr.set_rel(rel);
+    adsr.trigger();
+    for (int n = 0; n < NUM_SAMPLES; ++n)
+    {
+        if (n == RELEASE_SAMPLE)
+            adsr.release();
+
+        int const time = n < RELEASE_SAMPLE ? n : n - RELEASE_SAMPLE;
+        real const expected = adsr.read(static_cast<real>(time) / SAMPLE_RATE);
+        EXPECT_NEAR(out[n], expected, 1e-5) << "sample " << n;
+    }
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+/**
+ * @brief mseg_envelope_test
+ */
+TEST(mseg_envelope_test, test_adsr_special_case)
+{
+    testMsegMatchesAdsr(0.5f, 0.7f, 0.5f, 0.3f);
+    testMsegMatchesAdsr(0.01f, 0.1f, 0.8f, 1.f);
+    testMsegMatchesAdsr(0.f, 0.f, 0.3f, 0.f);
+    // Release in attack
+    testMsegMatchesAdsr(3.f, 2.f, 0.5f, 3.f);
+}
+
+//-----------------------------------------------------------------------------
+TEST(mseg_envelope_test, test_block_size_independent)
+{
+    Mseg const mseg = MsegImpl::create_adsr(0.1f, 0.2f, 0.6f, 0.3f, 44100.f);
+    auto const single = render_mseg(mseg, 44100, 22016, 1);
+    auto const block  = render_mseg(mseg, 44100, 22016, 512);
+    for (size_t i = 0; i < single.size(); ++i)
+        EXPECT_FLOAT_EQ(single[i], block[i]);
+}
+
+//-----------------------------------------------------------------------------
+TEST(mseg_envelope_test, test_loop)
+{
+    // Triangle looping between 0 and 1 with a period of 100 samples.
+    Mseg mseg = MsegImpl::create(100.f);
+    MsegImpl::set_segment(mseg, 0, {0.5f, 1.f, MsegCurve::Linear});
+    MsegImpl::set_segment(mseg, 1, {0.5f, 0.f, MsegCurve::Linear});
+    MsegImpl::set_segment(mseg, 2, {0.5f, 0.f, MsegCurve::Hold});
+    MsegImpl::set_num_segments(mseg, 3);
+    MsegImpl::set_loop(mseg, 0, 1);
+    MsegImpl::set_release_segment(mseg, 2);
+
+    MsegVoice voice;
+    MsegImpl::trigger(mseg, voice);
+    std::vector<mut_real> out(400);
+    MsegImpl::render(mseg, voice, out.data(), 400);
+
+    EXPECT_FLOAT_EQ(out[0], 0.f);
+    EXPECT_FLOAT_EQ(out[25], 0.5f);
+    EXPECT_FLOAT_EQ(out[50], 1.f);
+    for (int i = 101; i < 400; ++i)
+        EXPECT_NEAR(out[i], out[i - 100], 1e-5) << "sample " << i;
+
+    MsegImpl::release(mseg, voice);
+    MsegImpl::render(mseg, voice, out.data(), 100);
+    EXPECT_FLOAT_EQ(out[99], 0.f);
+}
+
+//-----------------------------------------------------------------------------
+TEST(mseg_envelope_test, test_zero_duration_loop_terminates)
+{
+    Mseg mseg = MsegImpl::create(44100.f);
+    MsegImpl::set_segment(mseg, 0, {0.f, 1.f, MsegCurve::Linear});
+    MsegImpl::set_num_segments(mseg, 1);
+    MsegImpl::set_loop(mseg, 0, 0);
+
+    MsegVoice voice;
+    MsegImpl::trigger(mseg, voice);
+    std::vector<mut_real> out(16);
+    MsegImpl::render(mseg, voice, out.data(), 16);
+    EXPECT_FLOAT_EQ(out[15], 1.f);
+}
+
+//-----------------------------------------------------------------------------
+TEST(mseg_envelope_test, test_bank_matches_voice)
+{
+    constexpr int NUM_VOICES = 8;
+    Mseg const mseg = MsegImpl::create_adsr(0.01f, 0.05f, 0.4f, 0.02f, 48000.f);
+
+    MsegBank bank = MsegBankImpl::create(NUM_VOICES);
+    EXPECT_EQ(MsegBankImpl::size(bank), NUM_VOICES);
+    std::vector<MsegVoice> voices(NUM_VOICES);
+
+    std::vector<mut_real> bank_out(NUM_VOICES * BLOCK_SIZE);
+    std::vector<mut_real> voice_out(BLOCK_SIZE);
+    for (int block = 0; block < 100; ++block)
+    {
+        for (int v = 0; v < NUM_VOICES; ++v)
+        {
+            if (block == v * 3)
+            {
+                MsegBankImpl::trigger(mseg, bank, v);
+                MsegImpl::trigger(mseg, voices[v]);
+            }
+            if (block == v * 3 + 20)
+            {
+                MsegBankImpl::release(mseg, bank, v);
+                MsegImpl::release(mseg, voices[v]);
+            }
+        }
+
+        MsegBankImpl::render(mseg, bank, bank_out.data(), BLOCK_SIZE);
+        for (int v = 0; v < NUM_VOICES; ++v)
+        {
+            MsegImpl::render(mseg, voices[v], voice_out.data(), BLOCK_SIZE);
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+                EXPECT_EQ(bank_out[v * BLOCK_SIZE + i], voice_out[i]);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
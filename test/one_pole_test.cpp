@@ -1,7 +1,9 @@
 // Copyright(c) 2021 Hansen Audio.
 
 #include "ha/dsp_tool_box/filtering/one_pole.h"
+#include "ha/dsp_tool_box/filtering/one_pole_bank.h"
 #include "gtest/gtest.h"
+#include <vector>
 
 using namespace ha::dtb::filtering;
 
@@ -16,4 +18,34 @@ TEST(one_pole_test, test_one_pole_initialisation)
     EXPECT_FLOAT_EQ(one_pole.z, 0.0);
 }
 
+//-----------------------------------------------------------------------------
+TEST(one_pole_test, test_one_pole_bank_matches_one_pole)
+{
+    using mut_real = ha::dtb::mut_real;
+
+    constexpr int NUM_FILTERS = 5;
+    constexpr int NUM_SAMPLES = 16;
+    auto bank                 = OnePoleBankImpl::create(NUM_FILTERS);
+    std::vector<OnePole> filters(NUM_FILTERS, OnePoleImpl::create());
+    for (int f = 0; f < NUM_FILTERS; ++f)
+    {
+        float const a = 0.5f + 0.1f * static_cast<float>(f);
+        OnePoleBankImpl::update_pole(bank, f, a);
+        OnePoleImpl::update_pole(filters[f], a);
+    }
+
+    std::vector<mut_real> in(NUM_FILTERS * NUM_SAMPLES, 1.f);
+    std::vector<mut_real> out(NUM_FILTERS * NUM_SAMPLES);
+    OnePoleBankImpl::process(bank, in.data(), out.data(), NUM_SAMPLES);
+
+    for (int s = 0; s < NUM_SAMPLES; ++s)
+    {
+        for (int f = 0; f < NUM_FILTERS; ++f)
+        {
+            EXPECT_FLOAT_EQ(out[s * NUM_FILTERS + f],
+                            OnePoleImpl::process(filters[f], 1.f));
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,147 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/filtering/oversampler.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+
+using namespace ha::dtb;
+using namespace ha::dtb::filtering;
+
+namespace {
+
+//-----------------------------------------------------------------------------
+constexpr int BLOCK_SIZE  = 64;
+constexpr int NUM_BLOCKS  = 32;
+constexpr double PI       = 3.14159265358979323846;
+//! Whole periods in half of the test signal, so amplitude() does not leak
+constexpr double FREQ_LOW = 1. / 128.;
+
+//-----------------------------------------------------------------------------
+std::vector<mut_real> sine(double freq, double delay, int num)
+{
+    std::vector<mut_real> out(static_cast<size_t>(num));
+    for (int i = 0; i < num; ++i)
+        out[i] = static_cast<real>(std::sin(2. * PI * freq * (i - delay)));
+    return out;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<mut_real> round_trip(Oversampler& self,
+                                 std::vector<mut_real> const& in,
+                                 int block_size)
+{
+    using core::BufferViewImpl;
+
+    std::vector<mut_real> out(in.size());
+    int const num = static_cast<int>(in.size());
+    for (int i = 0; i < num; i += block_size)
+    {
+        int const count = std::min(block_size, num - i);
+        OversamplerImpl::process(self,
+                                 BufferViewImpl::channel(in.data() + i, count),
+                                 BufferViewImpl::channel(out.data() + i, count),
+                                 [](core::MutChannelView const&) {});
+    }
+    return out;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Amplitude of freq in the signal, a single bin DFT
+ */
+double amplitude(real const* data, int num, double freq)
+{
+    double re = 0., im = 0.;
+    for (int i = 0; i < num; ++i)
+    {
+        re += data[i] * std::cos(2. * PI * freq * i);
+        im += data[i] * std::sin(2. * PI * freq * i);
+    }
+    return 2. * std::sqrt(re * re + im * im) / num;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+/**
+ * @brief oversampler_test
+ */
+TEST(oversampler_test, test_round_trip_delays_by_latency)
+{
+    int const num = BLOCK_SIZE * NUM_BLOCKS;
+    auto const in = sine(FREQ_LOW, 0., num);
+    for (int factor : {1, 2, 4, 8})
+    {
+        auto oversampler     = OversamplerImpl::create(factor, BLOCK_SIZE);
+        double const latency = OversamplerImpl::latency(oversampler);
+        auto const out       = round_trip(oversampler, in, BLOCK_SIZE);
+
+        auto const expected = sine(FREQ_LOW, latency, num);
+        for (int i = 2 * BLOCK_SIZE; i < num; ++i)
+            EXPECT_NEAR(out[i], expected[i], 1e-3) << factor;
+    }
+
+    EXPECT_EQ(OversamplerImpl::latency(OversamplerImpl::create(1, 1)), 0.f);
+    EXPECT_EQ(OversamplerImpl::latency(OversamplerImpl::create(2, 1)), 23.f);
+}
+
+//-----------------------------------------------------------------------------
+TEST(oversampler_test, test_minimum_phase_has_lower_latency)
+{
+    int const num = BLOCK_SIZE * NUM_BLOCKS;
+    auto const in = sine(FREQ_LOW, 0., num);
+    for (int factor : {2, 4, 8})
+    {
+        auto linear  = OversamplerImpl::create(factor, BLOCK_SIZE);
+        auto minimum = OversamplerImpl::create(
+            factor, BLOCK_SIZE, Oversampler::Response::MinimumPhase);
+        EXPECT_LT(OversamplerImpl::latency(minimum),
+                  OversamplerImpl::latency(linear) / 2);
+
+        auto const out   = round_trip(minimum, in, BLOCK_SIZE);
+        real const* tail = out.data() + num / 2;
+        EXPECT_NEAR(amplitude(tail, num / 2, FREQ_LOW), 1., 1e-3) << factor;
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(oversampler_test, test_images_are_rejected)
+{
+    constexpr double FREQ = 0.25;
+    int const num         = BLOCK_SIZE * NUM_BLOCKS;
+    auto const in         = sine(FREQ, 0., num);
+    for (auto response : {Oversampler::Response::LinearPhase,
+                          Oversampler::Response::MinimumPhase})
+    {
+        auto oversampler = OversamplerImpl::create(2, num, response);
+        auto const block = OversamplerImpl::upsample(
+            oversampler, core::BufferViewImpl::channel(in.data(), num));
+
+        // The image of FREQ at twice the rate is at 0.5 - FREQ / 2.
+        real const* tail = block.data + num;
+        EXPECT_NEAR(amplitude(tail, num, FREQ / 2), 1., 1e-3);
+        EXPECT_LT(amplitude(tail, num, 0.5 - FREQ / 2), 1e-3);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(oversampler_test, test_block_size_does_not_matter)
+{
+    int const num = BLOCK_SIZE * NUM_BLOCKS;
+    auto const in = sine(0.37, 0., num);
+    for (auto response : {Oversampler::Response::LinearPhase,
+                          Oversampler::Response::MinimumPhase})
+    {
+        auto whole = OversamplerImpl::create(8, num, response);
+        auto split = OversamplerImpl::create(8, BLOCK_SIZE, response);
+        EXPECT_EQ(round_trip(whole, in, num), round_trip(split, in, 13));
+
+        OversamplerImpl::reset(whole);
+        OversamplerImpl::reset(split);
+        EXPECT_EQ(round_trip(whole, in, num),
+                  round_trip(split, in, BLOCK_SIZE));
+    }
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,146 @@
+// Copyright(c) 2021 Hansen Audio.
+
+#include "ha/dsp_tool_box/synthesis/wavetable_oscillator.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+
+using namespace ha::dtb;
+using namespace ha::dtb::synthesis;
+
+/**
+ * @brief wavetable_oscillator_test
+ */
+TEST(wavetable_oscillator_test, test_tables_are_shared)
+{
+    auto osc_0 = WavetableOscillatorImpl::create(Waveform::Saw);
+    auto osc_1 = WavetableOscillatorImpl::create(Waveform::Saw);
+    EXPECT_EQ(osc_0.table.get(), osc_1.table.get());
+
+    WavetableOscillatorImpl::set_waveform(osc_1, Waveform::Square);
+    EXPECT_NE(osc_0.table.get(), osc_1.table.get());
+}
+
+//-----------------------------------------------------------------------------
+TEST(wavetable_oscillator_test, test_select_level)
+{
+    EXPECT_EQ(WavetableOscillatorImpl::select_level(0.f), 0);
+    EXPECT_EQ(WavetableOscillatorImpl::select_level(1.f / 2048.f), 0);
+    EXPECT_EQ(WavetableOscillatorImpl::select_level(1.f / 1024.f), 1);
+    EXPECT_EQ(WavetableOscillatorImpl::select_level(0.3f),
+              Wavetable::NUM_LEVELS - 1);
+}
+
+//-----------------------------------------------------------------------------
+TEST(wavetable_oscillator_test, test_sine)
+{
+    auto osc = WavetableOscillatorImpl::create(Waveform::Sine);
+    for (int i = 0; i < 100; ++i)
+    {
+        real phase = static_cast<real>(i) / 100.f;
+        EXPECT_NEAR(WavetableOscillatorImpl::process(osc, phase, 0.01f),
+                    std::sin(2. * 3.14159265358979323846 * phase),
+                    1e-5);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(wavetable_oscillator_test, test_high_saw_is_band_limited)
+{
+    // Above a quarter of the sample rate only the fundamental fits.
+    auto saw  = WavetableOscillatorImpl::create(Waveform::Saw);
+    auto sine = WavetableOscillatorImpl::create(Waveform::Sine);
+    real const increment = 0.3f;
+    for (int i = 0; i < 100; ++i)
+    {
+        real phase = static_cast<real>(i) / 100.f;
+        real const expected =
+            WavetableOscillatorImpl::process(sine, phase, increment) *
+            real(2. / 3.14159265358979323846);
+        EXPECT_NEAR(WavetableOscillatorImpl::process(saw, phase, increment),
+                    expected,
+                    1e-5);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(wavetable_oscillator_test, test_render_with_phase)
+{
+    auto phase = modulation::PhaseImpl::create();
+    modulation::PhaseImpl::set_sync_mode(phase,
+                                         modulation::Phase::SyncMode::Free);
+    modulation::PhaseImpl::set_sample_rate(phase, 48000.f);
+    modulation::PhaseImpl::set_rate(phase, 440.f);
+
+    auto osc          = WavetableOscillatorImpl::create(Waveform::Sine);
+    mut_real value    = 0.f;
+    mut_real expected = 0.f;
+    std::vector<mut_real> out(200);
+    WavetableOscillatorImpl::render(osc, phase, value, out.data(), 200);
+
+    real const increment = modulation::PhaseImpl::increment(phase);
+    for (int i = 0; i < 200; ++i)
+    {
+        EXPECT_NEAR(out[i],
+                    WavetableOscillatorImpl::process(osc, expected, increment),
+                    1e-4);
+        modulation::PhaseImpl::advance(phase, expected, 1);
+    }
+    EXPECT_NEAR(value, expected, 1e-5);
+}
+
+//-----------------------------------------------------------------------------
+TEST(wavetable_oscillator_test, test_render_backwards)
+{
+    auto phase = modulation::PhaseImpl::create();
+    modulation::PhaseImpl::set_sync_mode(phase,
+                                         modulation::Phase::SyncMode::Free);
+    modulation::PhaseImpl::set_sample_rate(phase, 48000.f);
+    modulation::PhaseImpl::set_rate(phase, -440.f);
+
+    auto osc       = WavetableOscillatorImpl::create(Waveform::Saw);
+    mut_real value = 0.5f;
+    std::vector<mut_real> out(200);
+    WavetableOscillatorImpl::render(osc, phase, value, out.data(), 200);
+
+    real const increment = modulation::PhaseImpl::increment(phase);
+    ASSERT_LT(increment, 0.f);
+    for (int i = 0; i < 200; ++i)
+    {
+        real const p = 0.5f + static_cast<real>(i) * increment;
+        EXPECT_NEAR(out[i],
+                    WavetableOscillatorImpl::process(osc, p - std::floor(p),
+                                                     increment),
+                    1e-4);
+    }
+    EXPECT_GE(value, 0.f);
+    EXPECT_LT(value, 1.f);
+}
+
+//-----------------------------------------------------------------------------
+TEST(wavetable_oscillator_test, test_render_project_sync)
+{
+    auto phase = modulation::PhaseImpl::create();
+    modulation::PhaseImpl::set_sync_mode(
+        phase, modulation::Phase::SyncMode::ProjectSync);
+    modulation::PhaseImpl::set_sample_rate(phase, 48000.f);
+    modulation::PhaseImpl::set_note_len(phase, 1.f / 4.f);
+    modulation::PhaseImpl::set_project_time(phase, 2.25f);
+
+    // The phase is taken from the project time, not from value.
+    auto osc       = WavetableOscillatorImpl::create(Waveform::Sine);
+    mut_real value = 0.9f;
+    std::vector<mut_real> out(64);
+    WavetableOscillatorImpl::render(osc, phase, value, out.data(), 64);
+
+    real const increment = modulation::PhaseImpl::increment(phase);
+    for (int i = 0; i < 64; ++i)
+    {
+        real const p = 0.25f + static_cast<real>(i) * increment;
+        EXPECT_NEAR(out[i],
+                    WavetableOscillatorImpl::process(osc, p, increment),
+                    1e-4);
+    }
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,442 @@
+// Copyright(c) 2021 Hansen Audio.
+
+/**
+ * @brief Offline accuracy and throughput validation of the library kernels.
+ *
+ * Every kernel is swept densely over its input domain and compared against a
+ * double precision reference. The report lists max/RMS error, monotonicity,
+ * the largest jump at stage boundaries and the throughput of the candidate.
+ * Returns a non-zero exit code if a kernel leaves its tolerance.
+ *
+ * Usage: dsp-tool-box_validate [--csv <file>]
+ */
+
+#include "ha/dsp_tool_box/core/cpu_dispatch.h"
+#include "ha/dsp_tool_box/filtering/one_pole.h"
+#include "ha/dsp_tool_box/modulation/adsr_envelope.h"
+#include "ha/dsp_tool_box/modulation/modulation_phase.h"
+#include "ha/dsp_tool_box/synthesis/wavetable_oscillator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace ha::dtb;
+
+namespace {
+
+//-----------------------------------------------------------------------------
+enum class Spacing
+{
+    Linear,
+    Logarithmic
+};
+
+enum class Metric
+{
+    Absolute,
+    //! Distance on the unit circle, e.g. 0.999 and 0.001 are 0.002 apart.
+    Circular
+};
+
+enum class Monotonicity
+{
+    None,
+    Increasing,
+    Decreasing
+};
+
+//-----------------------------------------------------------------------------
+struct Domain
+{
+    double begin;
+    double end;
+    int num_points;
+    Spacing spacing;
+};
+
+//-----------------------------------------------------------------------------
+struct KernelResult
+{
+    std::string name;
+    double max_abs_error     = 0.;
+    double rms_error         = 0.;
+    double max_discontinuity = 0.;
+    bool monotonic           = true;
+    double mevals_per_sec    = 0.;
+    double tolerance         = 0.;
+    bool passed              = false;
+};
+
+//-----------------------------------------------------------------------------
+std::vector<double> make_inputs(Domain const& domain)
+{
+    std::vector<double> inputs(static_cast<size_t>(domain.num_points));
+    double const last = static_cast<double>(domain.num_points - 1);
+    for (int i = 0; i < domain.num_points; ++i)
+    {
+        double const t = static_cast<double>(i) / last;
+        inputs[i] =
+            domain.spacing == Spacing::Linear
+                ? domain.begin + t * (domain.end - domain.begin)
+                : domain.begin * std::pow(domain.end / domain.begin, t);
+    }
+    return inputs;
+}
+
+//-----------------------------------------------------------------------------
+template <typename Candidate>
+double measure_throughput(std::vector<double> const& inputs,
+                          Candidate candidate)
+{
+    constexpr int NUM_RUNS = 5;
+
+    std::vector<mut_real> float_inputs(inputs.begin(), inputs.end());
+    volatile mut_real sink = 0.f;
+    double best_seconds    = 1e9;
+    for (int run = 0; run < NUM_RUNS; ++run)
+    {
+        mut_real acc     = 0.f;
+        auto const start = std::chrono::steady_clock::now();
+        for (real x : float_inputs)
+            acc += candidate(x);
+        auto const stop = std::chrono::steady_clock::now();
+        sink            = acc;
+
+        std::chrono::duration<double> const seconds = stop - start;
+        best_seconds = std::min(best_seconds, seconds.count());
+    }
+    (void)sink;
+
+    return static_cast<double>(inputs.size()) / best_seconds * 1e-6;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Compares candidate(float) against reference(double) on every input.
+ */
+template <typename Candidate, typename Reference>
+KernelResult sweep(char const* name,
+                   Domain const& domain,
+                   Candidate candidate,
+                   Reference reference,
+                   double tolerance,
+                   Monotonicity monotonicity,
+                   Metric metric = Metric::Absolute)
+{
+    KernelResult result;
+    result.name      = name;
+    result.tolerance = tolerance;
+
+    auto const inputs  = make_inputs(domain);
+    double sum_squared = 0.;
+    double previous    = 0.;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        double const x     = inputs[i];
+        double const value = candidate(static_cast<real>(x));
+        double const diff  = std::abs(value - reference(x));
+        double const error = metric == Metric::Circular
+                                 ? std::min(diff, 1. - diff)
+                                 : diff;
+
+        result.max_abs_error = std::max(result.max_abs_error, error);
+        sum_squared += error * error;
+
+        if (i > 0 && monotonicity == Monotonicity::Increasing)
+            result.monotonic &= value >= previous;
+        else if (i > 0 && monotonicity == Monotonicity::Decreasing)
+            result.monotonic &= value <= previous;
+
+        previous = value;
+    }
+
+    result.rms_error      = std::sqrt(sum_squared / inputs.size());
+    result.mevals_per_sec = measure_throughput(inputs, candidate);
+    result.passed = result.max_abs_error <= tolerance && result.monotonic;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+double reference_ease_virus_ti(double x)
+{
+    double const multiplicator =
+        std::log(std::pow(10., 96. / 20.)) / std::log(2.);
+    return 1. - std::pow(0.5, x * multiplicator);
+}
+
+//-----------------------------------------------------------------------------
+KernelResult validate_ease_virus_ti()
+{
+    return sweep(
+        "ease_virus_ti", {0., 1., 1 << 20, Spacing::Linear},
+        [](real x) { return modulation::easing::ease_virus_ti<real>(x); },
+        reference_ease_virus_ti, 1e-6, Monotonicity::Increasing);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Runs the dispatched easing kernel of isa over the whole domain at once.
+ */
+KernelResult validate_ease_kernel(core::Isa isa)
+{
+    constexpr int NUM_RUNS = 5;
+
+    KernelResult result;
+    result.name = std::string("ease_kernel_") +
+                  core::CpuDispatchImpl::to_string(isa);
+    result.tolerance = 1e-6;
+
+    auto const inputs = make_inputs({0., 1., 1 << 20, Spacing::Linear});
+    std::vector<mut_real> in(inputs.begin(), inputs.end());
+    std::vector<mut_real> out(in.size());
+    i32 const num = static_cast<i32>(in.size());
+
+    auto const& kernels = core::CpuDispatchImpl::kernels(isa);
+    double best_seconds = 1e9;
+    for (int run = 0; run < NUM_RUNS; ++run)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        kernels.ease_virus_ti(in.data(), out.data(), num);
+        auto const stop = std::chrono::steady_clock::now();
+
+        std::chrono::duration<double> const seconds = stop - start;
+        best_seconds = std::min(best_seconds, seconds.count());
+    }
+
+    double sum_squared = 0.;
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        double const error =
+            std::abs(out[i] - reference_ease_virus_ti(double(in[i])));
+        result.max_abs_error = std::max(result.max_abs_error, error);
+        sum_squared += error * error;
+        if (i > 0)
+            result.monotonic &= out[i] >= out[i - 1];
+    }
+
+    result.rms_error      = std::sqrt(sum_squared / in.size());
+    result.mevals_per_sec = double(in.size()) / best_seconds * 1e-6;
+    result.passed =
+        result.max_abs_error <= result.tolerance && result.monotonic;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+KernelResult validate_tau_to_pole(real sample_rate, char const* name)
+{
+    return sweep(
+        name, {1e-4, 10., 1 << 18, Spacing::Logarithmic},
+        [sample_rate](real tau) {
+            return filtering::OnePoleImpl::tau_to_pole(tau, sample_rate);
+        },
+        [sample_rate](double tau) {
+            return std::exp(-1. / ((tau / 5.) * sample_rate));
+        },
+        1e-6, Monotonicity::Increasing);
+}
+
+//-----------------------------------------------------------------------------
+KernelResult validate_phase_wrap()
+{
+    // Advancing by zero samples only wraps the value into [0, 1).
+    auto phase = modulation::PhaseImpl::create();
+    modulation::PhaseImpl::set_sync_mode(phase,
+                                         modulation::Phase::SyncMode::Free);
+    return sweep(
+        "phase_wrap", {0., 1.9999, 1 << 20, Spacing::Linear},
+        [phase](real x) {
+            mut_real value = x;
+            modulation::PhaseImpl::advance(phase, value, 0);
+            return value;
+        },
+        [](double x) { return std::fmod(double(real(x)), 1.); }, 1e-6,
+        Monotonicity::None);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Accumulates a free running phase sample by sample for one second and
+ * compares the result against a double precision accumulator.
+ */
+KernelResult validate_phase_drift()
+{
+    constexpr real SAMPLE_RATE = real(44100.);
+    return sweep(
+        "phase_drift_1s", {0.01, 100., 256, Spacing::Logarithmic},
+        [SAMPLE_RATE](real rate) {
+            auto phase = modulation::PhaseImpl::create();
+            modulation::PhaseImpl::set_sync_mode(
+                phase, modulation::Phase::SyncMode::Free);
+            modulation::PhaseImpl::set_sample_rate(phase, SAMPLE_RATE);
+            modulation::PhaseImpl::set_rate(phase, rate);
+
+            mut_real value = real(0.);
+            for (int i = 0; i < int(SAMPLE_RATE); ++i)
+                modulation::PhaseImpl::advance(phase, value, 1);
+            return value;
+        },
+        [SAMPLE_RATE](double rate) {
+            return std::fmod(double(real(rate)), 1.);
+        },
+        5e-3, Monotonicity::None, Metric::Circular);
+}
+
+//-----------------------------------------------------------------------------
+KernelResult validate_wavetable_sine()
+{
+    using namespace synthesis;
+    auto const osc = WavetableOscillatorImpl::create(Waveform::Sine);
+    return sweep(
+        "wavetable_sine", {0., 0.9999999, 1 << 20, Spacing::Linear},
+        [osc](real phase) {
+            return WavetableOscillatorImpl::process(osc, phase, real(0.01));
+        },
+        [](double phase) {
+            return std::sin(2. * 3.14159265358979323846 * double(real(phase)));
+        },
+        1e-6, Monotonicity::None);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Reads the envelope right before and after each stage boundary and reports
+ * the largest jump. The error columns hold the deviation from the reference
+ * envelope computed in double precision.
+ */
+KernelResult validate_adsr_boundaries()
+{
+    constexpr real ATT = real(0.01);
+    constexpr real REL = real(0.5);
+    constexpr real INF = HUGE_VALF;
+
+    KernelResult result;
+    result.name      = "adsr_boundaries";
+    result.tolerance = 1e-4;
+
+    auto const sustain_levels = make_inputs({0., 1., 101, Spacing::Linear});
+    auto const decay_times = make_inputs({1e-3, 5., 64, Spacing::Logarithmic});
+    for (double sus : sustain_levels)
+    {
+        for (double dec : decay_times)
+        {
+            modulation::adsr_envelope_processor adsr;
+            adsr.set_att(ATT);
+            adsr.set_dec(real(dec));
+            adsr.set_sus(real(sus));
+            adsr.set_rel(REL);
+
+            real const boundaries[] = {ATT, ATT + real(dec)};
+            for (real boundary : boundaries)
+            {
+                adsr.trigger();
+                real const before = adsr.read(std::nextafter(boundary, 0.f));
+                adsr.trigger();
+                real const after = adsr.read(std::nextafter(boundary, INF));
+                result.max_discontinuity = std::max(
+                    result.max_discontinuity, double(std::abs(after - before)));
+            }
+
+            adsr.trigger();
+            adsr.read(ATT + real(dec) + real(1.));
+            adsr.release();
+            real const before = adsr.read(std::nextafter(REL, 0.f));
+            real const after  = adsr.read(std::nextafter(REL, INF));
+            result.max_discontinuity = std::max(
+                result.max_discontinuity, double(std::abs(after - before)));
+
+            double const reference_sus =
+                1. + (sus - 1.) * reference_ease_virus_ti(1.);
+            adsr.trigger();
+            real const settled = adsr.read(ATT + real(dec) * real(0.999999));
+            result.max_abs_error = std::max(
+                result.max_abs_error, std::abs(settled - reference_sus));
+        }
+    }
+
+    result.passed = result.max_discontinuity <= result.tolerance &&
+                    result.max_abs_error <= result.tolerance;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+void print_report(std::vector<KernelResult> const& results)
+{
+    std::printf("%-18s %12s %12s %12s %6s %10s %10s %6s\n", "kernel",
+                "max_error", "rms_error", "max_jump", "mono", "Meval/s",
+                "tolerance", "result");
+    for (auto const& r : results)
+    {
+        std::printf("%-18s %12.3e %12.3e %12.3e %6s %10.1f %10.1e %6s\n",
+                    r.name.c_str(), r.max_abs_error, r.rms_error,
+                    r.max_discontinuity, r.monotonic ? "yes" : "no",
+                    r.mevals_per_sec, r.tolerance, r.passed ? "ok" : "FAIL");
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool write_csv(std::vector<KernelResult> const& results, char const* path)
+{
+    FILE* file = std::fopen(path, "w");
+    if (!file)
+        return false;
+
+    std::fprintf(file, "kernel,max_error,rms_error,max_jump,monotonic,"
+                       "mevals_per_sec,tolerance,passed\n");
+    for (auto const& r : results)
+    {
+        std::fprintf(file, "%s,%.9e,%.9e,%.9e,%d,%.3f,%.3e,%d\n",
+                     r.name.c_str(), r.max_abs_error, r.rms_error,
+                     r.max_discontinuity, r.monotonic ? 1 : 0,
+                     r.mevals_per_sec, r.tolerance, r.passed ? 1 : 0);
+    }
+    std::fclose(file);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    char const* csv_path = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            csv_path = argv[++i];
+    }
+
+    std::vector<KernelResult> results;
+    results.push_back(validate_ease_virus_ti());
+    for (int i = 0; i < static_cast<int>(core::Isa::Count); ++i)
+    {
+        auto const isa = static_cast<core::Isa>(i);
+        if (core::CpuDispatchImpl::is_supported(isa))
+            results.push_back(validate_ease_kernel(isa));
+    }
+    results.push_back(validate_tau_to_pole(real(44100.), "tau_to_pole_44k1"));
+    results.push_back(validate_tau_to_pole(real(192000.), "tau_to_pole_192k"));
+    results.push_back(validate_phase_wrap());
+    results.push_back(validate_phase_drift());
+    results.push_back(validate_adsr_boundaries());
+    results.push_back(validate_wavetable_sine());
+
+    print_report(results);
+    if (csv_path && !write_csv(results, csv_path))
+    {
+        std::fprintf(stderr, "Could not write %s\n", csv_path);
+        return 2;
+    }
+
+    for (auto const& r : results)
+    {
+        if (!r.passed)
+            return 1;
+    }
+
+    return 0;
+}